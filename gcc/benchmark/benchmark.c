@@ -1,11 +1,15 @@
+// Compilazione: gcc -O2 [-fopenmp] benchmark.c primeLib.c -o benchmark
 #include <stdio.h> // input/output
 #include <stdlib.h> // calloc, free, exit
 #include <stdbool.h> // true/false e bool
 #include <time.h> // clock, CLOCK_PER_SEC
+#include <string.h> // strcmp
+#include "primeLib.h" // crivello segmentato, pi(x)
 
 unsigned long long limite;
 unsigned long long conteggio_metodo1 = 0;
 unsigned long long conteggio_metodo2 = 0;
+unsigned long long conteggio_metodo3 = 0;
 clock_t inizio, fine;
 double tempo;
 // metodo base
@@ -36,46 +40,18 @@ bool isPrimo(unsigned long long limite, unsigned long long *contatore) {
     return true;
 }
 
-// crivello
+// crivello segmentato (primeLib.c): memoria O(sqrt(limite)) invece di limite+1 byte
 void criveloDiEratostene(unsigned long long limite, unsigned long long *contatore) {
-    *contatore = 0;
-    
-    bool *numeriPrimi = (bool*)malloc((limite + 1) * sizeof(bool));
-    if (!numeriPrimi) {
-        printf("Errore di allocazione memoria\n");
-        exit(1);
-    }
-    
-    // considera tutti i numeri primi
-    for (unsigned long long i = 0; i <= limite; i++) {
-        numeriPrimi[i] = true;
-    }
-    
-    // 0 e 1 non sono primi
-    numeriPrimi[0] = numeriPrimi[1] = false;
-    
-    // Applica il Crivello di Eratostene
-    for (unsigned long long i = 2; i * i <= limite; i++) {
-        // se i è primo, elimina tutti multipli
-        if (numeriPrimi[i]) {
-            for (unsigned long long j = i * i; j <= limite; j += i) {
-                numeriPrimi[j] = false;
-            }
-        }
-    }
-    
-    // numeri primi trovati
-    for (unsigned long long i = 2; i <= limite; i++) {
-        if (numeriPrimi[i]) {
-            (*contatore)++;
-        }
-    }
-    
-    // Libera la memoria
-    free(numeriPrimi);
+    *contatore = sieve_count(limite, NULL, NULL);
 }
 
-int main() {
+// Uso: ./programma [byte|wheel30]  -> rappresentazione del crivello (default wheel30)
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "byte") == 0)
+        sieve_set_backend(SIEVE_BYTE);
+    else if (argc > 1 && strcmp(argv[1], "wheel30") == 0)
+        sieve_set_backend(SIEVE_WHEEL30);
+
     
     printf("Inserire il limite per la ricerca dei numeri primi: ");
     scanf("%llu", &limite);
@@ -94,12 +70,19 @@ int main() {
     tempo = (double)(fine - inizio) / CLOCKS_PER_SEC;
     printf("Metodo crivello: trovati %llu numeri primi fino a %llu in %.2f secondi\n", conteggio_metodo2, limite, tempo);
     
-    // Verifica che i due metodi diano lo stesso risultato
-    if (conteggio_metodo1 == conteggio_metodo2) {
-        printf("I due metodi hanno dato lo stesso risultato: %llu numeri primi trovati.\n", conteggio_metodo1);
+    // m pi(x): conta senza enumerare (Lucy_Hedgehog)
+    inizio = clock();
+    conteggio_metodo3 = prime_count(limite);
+    fine = clock();
+    tempo = (double)(fine - inizio) / CLOCKS_PER_SEC;
+    printf("Metodo pi(x): trovati %llu numeri primi fino a %llu in %.2f secondi\n", conteggio_metodo3, limite, tempo);
+    
+    // Verifica che i tre metodi diano lo stesso risultato
+    if (conteggio_metodo1 == conteggio_metodo2 && conteggio_metodo2 == conteggio_metodo3) {
+        printf("I tre metodi hanno dato lo stesso risultato: %llu numeri primi trovati.\n", conteggio_metodo1);
     } else {
-        printf("ERRORE: i due metodi hanno dato risultati diversi!\n");
-        printf("Differenza: metodo1=%llu, metodo2=%llu\n", conteggio_metodo1, conteggio_metodo2);
+        printf("ERRORE: i metodi hanno dato risultati diversi!\n");
+        printf("Differenza: metodo1=%llu, metodo2=%llu, metodo3=%llu\n", conteggio_metodo1, conteggio_metodo2, conteggio_metodo3);
     }
     
     return 0;
@@ -1,90 +1,44 @@
+// Compilazione: gcc -O2 -fopenmp multicore.c primeLib.c -o multicore
 #include <stdio.h> // input/output
 #include <stdlib.h> // calloc, free, exit
 #include <time.h> // clock, CLOCK_PER_SEC
 #include <omp.h> // utilizzo multicore
 #include <stdbool.h> // per bool
+#include <string.h> // strcmp
+#include "primeLib.h" // crivello segmentato, Miller-Rabin, pi(x)
 unsigned long long limite = 0;
 unsigned long long count_inge = 0;
 unsigned long long count_erato = 0;
 double start_time, end_time;
 
-// m ingenuo 
+// Test di primalita': Miller-Rabin deterministico (primeLib.c), O(log n) per numero
 int isPrime(unsigned long long n) {
-    if (n <= 1) return 0;  // 0 e 1 non sono primi
-    if (n <= 3) return 1;  // 2 e 3 sono primi
-    if (n % 2 == 0 || n % 3 == 0) return 0;  // elimino divisibili per 2 e per 3
-    
-    unsigned long long i = 5;
-    while (i * i <= n) { // basta controllare fino alla radice quadrata
-        if (n % i == 0 || n % (i + 2) == 0) return 0; // utilizza il metodo 6k +1
-        i += 6;
-    }
-    return 1;
+    return is_prime_u64(n);
 }
 
-// m crivello
+// m crivello: crivello segmentato parallelo (primeLib.c), ogni thread crivella
+// blocchi disgiunti con il proprio contatore locale
 void isPrimeErato(unsigned long long limite, unsigned long long *contatore) {
-    // add 2 pk  primo pari
-    *contatore = 1;
-    
-    // solo numeri dispari (3, 5, 7, ...)
-    unsigned long long dimensione = (limite - 1) / 2;
-    
-    //  l'array (false = primo, true = no)
-    bool *nonPrimi = (bool*)calloc(dimensione, sizeof(bool));
-    if (!nonPrimi) {
-        printf("Errore di allocazione memoria\n");
-        exit(1);
-    }
-    
-    // Usando OpenMP per parallelizzare il crivello
-    #pragma omp parallel
-    {
-        // crivello (non parallelizzabile)
-        #pragma omp single
-        {
-            for (unsigned long long i = 0; i < dimensione; i++) {
-                if (!nonPrimi[i]) {
-                    unsigned long long numero = 2 * i + 3;
-                    
-                    // Marchiamo i multipli come non primi
-                    unsigned long long indice_iniziale = (numero * numero - 3) / 2;
-                    if (indice_iniziale < dimensione) {
-                        for (unsigned long long j = indice_iniziale; j < dimensione; j += numero) {
-                            nonPrimi[j] = true;
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Conteggio 
-        unsigned long long contatore_locale = 0;
-        #pragma omp for schedule(dynamic, 1000)
-        for (unsigned long long i = 0; i < dimensione; i++) {
-            if (!nonPrimi[i]) {
-                contatore_locale++;
-            }
-        }
-        
-        // Aggiorniamo il contatore 
-        #pragma omp atomic
-        *contatore += contatore_locale;
-    }
-    
-    free(nonPrimi);
+    *contatore = sieve_count_parallel(limite);
 }
 
-int main() {
+// Uso: ./programma [byte|wheel30]  -> rappresentazione del crivello (default wheel30)
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "byte") == 0)
+        sieve_set_backend(SIEVE_BYTE);
+    else if (argc > 1 && strcmp(argv[1], "wheel30") == 0)
+        sieve_set_backend(SIEVE_WHEEL30);
+
     unsigned long long limite;
     unsigned long long count_inge = 0;
     unsigned long long count_erato = 0;
+    unsigned long long count_pi = 0;
     double start_time, end_time;
     
     printf("Inserire il limite per la ricerca dei numeri primi: ");
     scanf("%llu", &limite);
     
-    // Metodo ingenuo con OpenMP - usa omp_get_wtime() per misurare il tempo reale
+    // Miller-Rabin con OpenMP - usa omp_get_wtime() per misurare il tempo reale
     start_time = omp_get_wtime();
     #pragma omp parallel for reduction(+:count_inge)
     for (unsigned long long i = 2; i <= limite; i++) {
@@ -93,7 +47,7 @@ int main() {
         }
     }
     end_time = omp_get_wtime();
-    printf("Metodo ingenuo: trovati %llu numeri primi fino a %llu in %f secondi\n", count_inge, limite, end_time - start_time);
+    printf("Metodo Miller-Rabin: trovati %llu numeri primi fino a %llu in %f secondi\n", count_inge, limite, end_time - start_time);
     
     // crivello migliorato
     start_time = omp_get_wtime();
@@ -101,12 +55,18 @@ int main() {
     end_time = omp_get_wtime();
     printf("Metodo crivello: trovati %llu numeri primi fino a %llu in %f secondi\n", count_erato, limite, end_time - start_time);
     
+    // pi(x) di Lucy_Hedgehog, ogni passo diviso tra i thread
+    start_time = omp_get_wtime();
+    count_pi = prime_count(limite);
+    end_time = omp_get_wtime();
+    printf("Metodo pi(x): trovati %llu numeri primi fino a %llu in %f secondi\n", count_pi, limite, end_time - start_time);
+    
     // verifica 
-    if (count_inge == count_erato) {
-        printf("I due metodi hanno dato lo stesso risultato: %llu numeri primi trovati.\n", count_inge);
+    if (count_inge == count_erato && count_erato == count_pi) {
+        printf("I tre metodi hanno dato lo stesso risultato: %llu numeri primi trovati.\n", count_inge);
     } else {
-        printf("ERRORE: i due metodi hanno dato risultati diversi!\n");
-        printf("Differenza: ingenuo=%llu, eratostene=%llu\n", count_inge, count_erato);
+        printf("ERRORE: i metodi hanno dato risultati diversi!\n");
+        printf("Differenza: ingenuo=%llu, eratostene=%llu, pi(x)=%llu\n", count_inge, count_erato, count_pi);
     }
     
     return 0;
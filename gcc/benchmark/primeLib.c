@@ -0,0 +1,776 @@
+#include <stdlib.h>
+#include <string.h>
+#include "primeLib.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Un byte per numero dispari: il segmento da 32 KB copre 64K numeri e sta in L1,
+// cosi' le cancellazioni dei multipli non escono mai dalla cache.
+#define SEGMENT_BYTES (32 * 1024)
+
+// Nel crivello parallelo ogni thread prende blocchi da CHUNK_SEGMENTS segmenti:
+// il calcolo dei primi multipli (una divisione per primo base) si ripaga su 8M numeri.
+#define CHUNK_SEGMENTS 256
+
+static uint64_t isqrt(uint64_t n) {
+    uint64_t r = 0;
+    for (uint64_t bit = 1ULL << 31; bit; bit >>= 1) {
+        uint64_t t = r | bit;
+        if (t * t <= n)
+            r = t;
+    }
+    return r;
+}
+
+// Limite superiore di pi(x) per x >= 2: pi(x) < 1.25506 x / ln x (Rosser-Schoenfeld), con
+// ln x >= floor(log2 x) * ln 2 per non dipendere da libm. Per x = 2^32 sovrastima del 20%.
+static size_t pi_upper_bound(uint64_t x) {
+    int bits = 63 - __builtin_clzll(x);               // floor(log2 x) >= 1
+    return (size_t)(1.25506 * (double)x / (0.69314718 * bits)) + 16;
+}
+
+size_t base_primes(uint64_t limit, uint32_t **out) {
+    *out = NULL;
+    if (limit < 3)
+        return 0;
+
+    // un bit per dispari (indice i -> numero 2i+1): per limit = 2^32 sono 256 MB invece di 2 GB,
+    // e primes dimensionato su pi(limit) invece che sul numero di dispari
+    size_t dim = (size_t)(limit - 1) / 2 + 1;
+    size_t cap = pi_upper_bound(limit) < dim ? pi_upper_bound(limit) : dim;
+    uint8_t *composto = calloc(dim / 8 + 1, 1);
+    uint32_t *primes = malloc(cap * sizeof(uint32_t));
+    if (!composto || !primes) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    size_t count = 0;
+    for (size_t i = 1; i < dim; i++) {
+        if (composto[i >> 3] & (1u << (i & 7)))
+            continue;
+        uint64_t p = 2 * i + 1;
+        primes[count++] = (uint32_t)p;
+        for (uint64_t j = p * p / 2; j < dim; j += p)
+            composto[j >> 3] |= (uint8_t)(1u << (j & 7));
+    }
+    free(composto);
+
+    *out = realloc(primes, (count ? count : 1) * sizeof(uint32_t));
+    return count;
+}
+
+// Crivella i dispari nell'intervallo di indici [ilo, ihi) (indice i -> numero 2i+1)
+// un segmento alla volta. next[k] tiene l'indice del prossimo multiplo di primes[k]
+// da cancellare, cosi' ogni primo base costa una divisione sola per tutto l'intervallo.
+static uint64_t sieve_range_byte(uint64_t ilo, uint64_t ihi, const uint32_t *primes, size_t np,
+                                 prime_sink sink, void *ctx) {
+    uint8_t *seg = malloc(SEGMENT_BYTES);
+    uint64_t *next = malloc((np ? np : 1) * sizeof(uint64_t));
+    uint64_t *found = sink ? malloc(SEGMENT_BYTES * sizeof(uint64_t)) : NULL;
+    if (!seg || !next || (sink && !found)) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    for (size_t k = 0; k < np; k++) {
+        uint64_t p = primes[k];
+        uint64_t j = p * p / 2;                       // primo multiplo utile: p^2
+        if (j < ilo)                                  // primo indice >= ilo con 2j+1 multiplo dispari di p
+            j = ilo + ((p - 1) / 2 + p - ilo % p) % p;
+        next[k] = j;
+    }
+
+    uint64_t count = 0;
+    for (uint64_t lo = ilo; lo < ihi; lo += SEGMENT_BYTES) {
+        size_t len = ihi - lo < SEGMENT_BYTES ? (size_t)(ihi - lo) : SEGMENT_BYTES;
+        uint64_t hi = lo + len;
+        memset(seg, 1, len);
+        if (lo == 0)
+            seg[0] = 0;                               // 1 non e' primo
+
+        for (size_t k = 0; k < np; k++) {
+            uint64_t p = primes[k];
+            uint64_t j = next[k];
+            if (j >= hi)
+                continue;
+            for (; j < hi; j += p)
+                seg[j - lo] = 0;
+            next[k] = j;
+        }
+
+        size_t seg_count = 0;
+        for (size_t i = 0; i < len; i++)
+            seg_count += seg[i];
+        count += seg_count;
+
+        if (sink && seg_count) {
+            size_t n = 0;
+            for (size_t i = 0; i < len; i++)
+                if (seg[i])
+                    found[n++] = 2 * (lo + i) + 1;
+            sink(found, n, ctx);
+        }
+    }
+
+    free(seg);
+    free(next);
+    free(found);
+    return count;
+}
+
+// —— Ruota mod 30, un bit per candidato ——
+// Un byte rappresenta i 30 numeri [30b, 30b+30): gli unici che possono essere primi
+// (oltre a 2, 3, 5) hanno resto 1, 7, 11, 13, 17, 19, 23, 29, cioe' 8 bit.
+// Rispetto a un byte per numero dispari la memoria scende di 15 volte.
+static const uint8_t wheel_res[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+static const int8_t wheel_bit[30] = {
+    -1, 0, -1, -1, -1, -1, -1, 1, -1, -1, -1, 2, -1, 3, -1,
+    -1, -1, 4, -1, 5, -1, -1, -1, 6, -1, -1, -1, -1, -1, 7};
+
+// Stato del crivello a ruota tra un segmento e l'altro. Per ogni primo base p >= 7
+// i multipli p*q con q coprimo con 30 formano 8 progressioni (una per resto di q):
+// nella k-esima il byte avanza di p e il bit da spegnere e' sempre lo stesso.
+// next[] tiene il prossimo byte di ogni progressione, mask[] il bit da spegnere.
+struct wheel_cursor {
+    const uint32_t *primes;
+    size_t np, first;                                 // primes[first] e' il primo >= 7
+    uint64_t *next;
+    uint8_t *mask;
+};
+
+static void wheel_cursor_init(struct wheel_cursor *w, const uint32_t *primes, size_t np,
+                              uint64_t blo) {
+    w->primes = primes;
+    w->np = np;
+    w->next = malloc((np ? np : 1) * 8 * sizeof(uint64_t));
+    w->mask = malloc((np ? np : 1) * 8);
+    if (!w->next || !w->mask) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    w->first = 0;                                     // 3 e 5 sono gia' fuori dalla ruota
+    while (w->first < np && primes[w->first] < 7)
+        w->first++;
+
+    for (size_t k = w->first; k < np; k++) {
+        uint64_t p = primes[k];
+        for (int i = 0; i < 8; i++) {
+            uint64_t r = wheel_res[i];
+            uint64_t q0 = p > r ? (p - r + 29) / 30 : 0;   // primo q = 30*q0 + r >= p
+            uint64_t b = p * q0 + p * r / 30;
+            if (b < blo)
+                b += (blo - b + p - 1) / p * p;
+            w->next[k * 8 + i] = b;
+            w->mask[k * 8 + i] = (uint8_t)~(1u << wheel_bit[p * r % 30]);
+        }
+    }
+}
+
+static void wheel_cursor_free(struct wheel_cursor *w) {
+    free(w->next);
+    free(w->mask);
+}
+
+// Crivella i byte [lo, lo+len) in seg; i segmenti vanno chiesti in ordine crescente
+static void wheel_segment(struct wheel_cursor *w, uint8_t *seg, uint64_t lo, size_t len) {
+    uint64_t hi = lo + len;
+    memset(seg, 0xFF, len);
+    if (lo == 0)
+        seg[0] &= (uint8_t)~1u;                       // 1 non e' primo
+
+    for (size_t k = w->first; k < w->np; k++) {
+        uint64_t p = w->primes[k];
+        for (int i = 0; i < 8; i++) {
+            uint64_t j = w->next[k * 8 + i];
+            uint8_t m = w->mask[k * 8 + i];
+            for (; j < hi; j += p)
+                seg[j - lo] &= m;
+            w->next[k * 8 + i] = j;
+        }
+    }
+}
+
+// Crivella i byte [blo, bhi) della ruota; limit serve a scartare i bit oltre il limite
+// nell'ultimo byte. Se dst != NULL il risultato resta in dst[0 .. bhi-blo)
+// (sempre un segmento alla volta).
+static uint64_t sieve_range_wheel(uint64_t blo, uint64_t bhi, uint64_t limit,
+                                  const uint32_t *primes, size_t np, prime_sink sink, void *ctx,
+                                  uint8_t *dst) {
+    uint8_t *buf = dst ? NULL : malloc(SEGMENT_BYTES);
+    uint64_t *found = sink ? malloc(SEGMENT_BYTES * 8 * sizeof(uint64_t)) : NULL;
+    if ((!dst && !buf) || (sink && !found)) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    struct wheel_cursor w;
+    wheel_cursor_init(&w, primes, np, blo);
+
+    uint64_t last_byte = limit / 30;
+    uint8_t last_mask = 0;                            // bit validi dell'ultimo byte
+    for (int i = 0; i < 8; i++)
+        if (wheel_res[i] <= limit % 30)
+            last_mask |= (uint8_t)(1u << i);
+
+    uint64_t count = 0;
+    for (uint64_t lo = blo; lo < bhi; lo += SEGMENT_BYTES) {
+        size_t len = bhi - lo < SEGMENT_BYTES ? (size_t)(bhi - lo) : SEGMENT_BYTES;
+        uint8_t *seg = dst ? dst + (lo - blo) : buf;
+        wheel_segment(&w, seg, lo, len);
+        if (lo + len - 1 == last_byte)
+            seg[len - 1] &= last_mask;
+
+        // conteggio: popcount a 64 bit
+        uint64_t seg_count = 0;
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t word;
+            memcpy(&word, seg + i, 8);
+            seg_count += (uint64_t)__builtin_popcountll(word);
+        }
+        for (; i < len; i++)
+            seg_count += (uint64_t)__builtin_popcount(seg[i]);
+        count += seg_count;
+
+        if (sink && seg_count) {
+            size_t n = 0;
+            for (size_t b = 0; b < len; b++) {
+                unsigned bits = seg[b];
+                while (bits) {
+                    found[n++] = 30 * (lo + b) + wheel_res[__builtin_ctz(bits)];
+                    bits &= bits - 1;
+                }
+            }
+            sink(found, n, ctx);
+        }
+    }
+
+    wheel_cursor_free(&w);
+    free(buf);
+    free(found);
+    return count;
+}
+
+// —— Selezione del backend ——
+static sieve_backend backend = SIEVE_WHEEL30;
+
+void sieve_set_backend(sieve_backend b) {
+    backend = b;
+}
+
+sieve_backend sieve_get_backend(void) {
+    return backend;
+}
+
+// Unita' da crivellare fino a limit: indici dei dispari oppure byte della ruota
+static uint64_t sieve_units(uint64_t limit) {
+    return backend == SIEVE_WHEEL30 ? limit / 30 + 1 : (limit + 1) / 2;
+}
+
+static uint64_t sieve_range(uint64_t lo, uint64_t hi, uint64_t limit, const uint32_t *primes,
+                            size_t np, prime_sink sink, void *ctx) {
+    if (backend == SIEVE_WHEEL30)
+        return sieve_range_wheel(lo, hi, limit, primes, np, sink, ctx, NULL);
+    return sieve_range_byte(lo, hi, primes, np, sink, ctx);
+}
+
+// Primi che il backend non rappresenta: il 2 (e 3, 5 con la ruota)
+static uint64_t sieve_small_primes(uint64_t limit, prime_sink sink, void *ctx) {
+    static const uint64_t small[3] = {2, 3, 5};
+    size_t n = backend == SIEVE_WHEEL30 ? (limit >= 5 ? 3 : limit >= 3 ? 2 : 1) : 1;
+    if (sink)
+        sink(small, n, ctx);
+    return n;
+}
+
+uint64_t sieve_count(uint64_t limit, prime_sink sink, void *ctx) {
+    if (limit < 2)
+        return 0;
+
+    uint32_t *primes;
+    size_t np = base_primes(isqrt(limit), &primes);
+    uint64_t count = sieve_small_primes(limit, sink, ctx);
+    count += sieve_range(0, sieve_units(limit), limit, primes, np, sink, ctx);
+
+    free(primes);
+    return count;
+}
+
+uint64_t sieve_count_parallel(uint64_t limit) {
+    if (limit < 2)
+        return 0;
+
+    // tabella dei primi base condivisa (sola lettura) tra tutti i thread
+    uint32_t *primes;
+    size_t np = base_primes(isqrt(limit), &primes);
+
+    uint64_t units = sieve_units(limit);
+    uint64_t chunk = (uint64_t)CHUNK_SEGMENTS * SEGMENT_BYTES;
+#ifdef _OPENMP
+    // almeno ~8 blocchi per thread per bilanciare il carico, ma mai sotto un segmento
+    uint64_t per_thread = units / ((uint64_t)omp_get_max_threads() * 8);
+    if (per_thread < chunk)
+        chunk = per_thread < SEGMENT_BYTES ? SEGMENT_BYTES : per_thread / SEGMENT_BYTES * SEGMENT_BYTES;
+#endif
+    long n_chunks = (long)((units + chunk - 1) / chunk);
+    uint64_t count = sieve_small_primes(limit, NULL, NULL);
+
+    // ogni blocco e' indipendente: il thread che lo prende lo crivella da solo e
+    // accumula nel proprio contatore, sommato agli altri solo alla fine (reduction)
+    #pragma omp parallel for schedule(dynamic, 1) reduction(+:count)
+    for (long c = 0; c < n_chunks; c++) {
+        uint64_t lo = (uint64_t)c * chunk;
+        uint64_t hi = lo + chunk < units ? lo + chunk : units;
+        count += sieve_range(lo, hi, limit, primes, np, NULL, NULL);
+    }
+
+    free(primes);
+    return count;
+}
+
+// —— pi(x) con l'algoritmo di Lucy_Hedgehog ——
+// S(v) = numeri in [2, v] non ancora cancellati. Servono solo i valori v = x / i, che
+// sono al massimo 2*sqrt(x): lo[v] per v <= r = sqrt(x), hi[i] = S(x / i) per i <= r.
+// Per ogni primo p <= r si toglie da S(v) (v >= p^2) chi ha p come fattore minimo:
+//   S(v) -= S(v / p) - S(p - 1)
+// Alla fine S(x) = hi[1] = pi(x). Tempo O(x^(3/4)), memoria O(sqrt(x)).
+
+// soglia sotto la quale un passo non vale l'avvio dei thread
+#define LUCY_PARALLEL_MIN 8192
+
+uint64_t prime_count(uint64_t x) {
+    if (x < 2)
+        return 0;
+
+    uint64_t r = isqrt(x);
+    uint64_t *lo = malloc((r + 1) * sizeof(uint64_t));
+    uint64_t *hi = malloc((r + 1) * sizeof(uint64_t));
+    uint64_t *tmp = malloc((r / 2 + 1) * sizeof(uint64_t));
+    if (!lo || !hi || !tmp) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    lo[0] = 0;
+    for (uint64_t v = 1; v <= r; v++)
+        lo[v] = v - 1;
+    for (uint64_t i = 1; i <= r; i++)
+        hi[i] = x / i - 1;
+
+    for (uint64_t p = 2; p <= r; p++) {
+        if (lo[p] == lo[p - 1])                       // p e' gia' stato cancellato
+            continue;
+        uint64_t sp = lo[p - 1], p2 = p * p;
+        uint64_t iend = x / p2 < r ? x / p2 : r;      // hi[i] cambia solo se x / i >= p^2
+        uint64_t ip = r / p < iend ? r / p : iend;    // per i <= ip, x / (i p) e' ancora in hi
+
+        // hi[i] legge hi[i p], che potrebbe gia' essere stato aggiornato da un altro thread:
+        // prima si copiano i valori vecchi in tmp, poi si aggiornano tutti gli hi[i] in parallelo
+        #pragma omp parallel for if (ip > LUCY_PARALLEL_MIN)
+        for (uint64_t i = 1; i <= ip; i++)
+            tmp[i] = hi[i * p];
+        #pragma omp parallel for if (iend > LUCY_PARALLEL_MIN)
+        for (uint64_t i = 1; i <= iend; i++)
+            hi[i] -= (i <= ip ? tmp[i] : lo[x / (i * p)]) - sp;
+
+        // lo[v] legge lo[v / p] con v / p <= r / p: sopra r / p le scritture non toccano
+        // valori letti da altri e vanno in parallelo, il resto a ritroso come nel seriale
+        uint64_t vsplit = r / p + 1 > p2 ? r / p + 1 : p2;
+        #pragma omp parallel for if (r > vsplit + LUCY_PARALLEL_MIN)
+        for (uint64_t v = vsplit; v <= r; v++)
+            lo[v] -= lo[v / p] - sp;
+        for (uint64_t v = vsplit - 1; v >= p2; v--)
+            lo[v] -= lo[v / p] - sp;
+    }
+
+    uint64_t count = hi[1];
+    free(lo);
+    free(hi);
+    free(tmp);
+    return count;
+}
+
+// —— Iteratore sui primi ——
+// Un segmento della ruota alla volta: i primi si leggono direttamente dai bit del
+// segmento, che viene ricrivellato sul posto quando e' esaurito. Tutta la memoria
+// (segmento, primi base, progressioni) si alloca in prime_iter_init.
+
+static const uint64_t iter_small[3] = {2, 3, 5};
+
+void prime_iter_init(prime_iter *it, uint64_t lo, uint64_t hi) {
+    memset(it, 0, sizeof(*it));
+    it->lo = lo;
+    it->hi = hi;
+    if (hi < 2 || lo > hi) {
+        it->small = 3;                                // intervallo vuoto
+        return;
+    }
+
+    it->unit = lo / 30;
+    it->end = hi / 30 + 1;
+    it->seg = malloc(SEGMENT_BYTES);
+    it->cur = malloc(sizeof(struct wheel_cursor));
+    if (!it->seg || !it->cur) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+    it->np = base_primes(isqrt(hi), &it->primes);
+    wheel_cursor_init(it->cur, it->primes, it->np, it->unit);
+}
+
+void prime_iter_free(prime_iter *it) {
+    if (it->cur)
+        wheel_cursor_free(it->cur);
+    free(it->cur);
+    free(it->seg);
+    free(it->primes);
+    memset(it, 0, sizeof(*it));
+}
+
+// Crivella il segmento successivo e spegne i bit fuori da [lo, hi]; 0 se finiti
+static int prime_iter_load(prime_iter *it) {
+    if (it->unit >= it->end)
+        return 0;
+    size_t len = it->end - it->unit < SEGMENT_BYTES ? (size_t)(it->end - it->unit) : SEGMENT_BYTES;
+    wheel_segment(it->cur, it->seg, it->unit, len);
+
+    if (it->unit == it->lo / 30)
+        for (int i = 0; i < 8; i++)
+            if (30 * it->unit + wheel_res[i] < it->lo)
+                it->seg[0] &= (uint8_t)~(1u << i);
+    if (it->unit + len == it->end)
+        for (int i = 0; i < 8; i++)
+            if (wheel_res[i] > it->hi % 30)
+                it->seg[len - 1] &= (uint8_t)~(1u << i);
+
+    it->seg_lo = it->unit;
+    it->seg_len = len;
+    it->pos = 0;
+    it->unit += len;
+    return 1;
+}
+
+uint64_t prime_iter_next(prime_iter *it) {
+    while (it->small < 3) {
+        uint64_t p = iter_small[it->small++];
+        if (p >= it->lo && p <= it->hi)
+            return p;
+    }
+    while (!it->bits) {
+        if (it->pos == it->seg_len && !prime_iter_load(it))
+            return 0;
+        it->base = 30 * (it->seg_lo + it->pos);
+        it->bits = it->seg[it->pos++];
+    }
+    unsigned b = (unsigned)__builtin_ctz(it->bits);
+    it->bits &= it->bits - 1;
+    return it->base + wheel_res[b];
+}
+
+size_t prime_iter_fill(prime_iter *it, uint64_t *buf, size_t n) {
+    size_t k = 0;
+    while (k < n && it->small < 3) {
+        uint64_t p = iter_small[it->small++];
+        if (p >= it->lo && p <= it->hi)
+            buf[k++] = p;
+    }
+
+    // copie locali dello stato: il ciclo interno resta tutto nei registri
+    const uint8_t *seg = it->seg;
+    uint64_t base = it->base;
+    unsigned bits = it->bits;
+    size_t pos = it->pos;
+    while (k < n) {
+        while (bits && k < n) {
+            buf[k++] = base + wheel_res[__builtin_ctz(bits)];
+            bits &= bits - 1;
+        }
+        if (k == n)
+            break;
+        if (pos == it->seg_len) {
+            if (!prime_iter_load(it))
+                break;
+            pos = 0;
+        }
+        base = 30 * (it->seg_lo + pos);
+        bits = seg[pos++];
+    }
+    it->base = base;
+    it->bits = bits;
+    it->pos = pos;
+    return k;
+}
+
+// —— Oracolo di primalita' ——
+// Bitset della ruota mod 30 (un byte ogni 30 numeri) tenuto per tutta la durata
+// dell'oracolo. Quando arriva un n oltre la parte gia' crivellata la tabella almeno
+// raddoppia e si crivellano solo i byte nuovi: costo ammortizzato O(1) per numero.
+
+void prime_oracle_init(prime_oracle *o) {
+    o->bits = NULL;
+    o->bytes = 0;
+}
+
+void prime_oracle_free(prime_oracle *o) {
+    free(o->bits);
+    prime_oracle_init(o);
+}
+
+static void prime_oracle_extend(prime_oracle *o, uint64_t n) {
+    uint64_t bytes = o->bytes * 2;
+    if (bytes < n / 30 + 1)
+        bytes = n / 30 + 1;
+    bytes = (bytes + SEGMENT_BYTES - 1) / SEGMENT_BYTES * SEGMENT_BYTES;
+
+    uint8_t *bits = realloc(o->bits, bytes);
+    if (!bits) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    // la tabella arriva a 30*bytes - 1: tutti i bit dell'ultimo byte sono validi
+    uint64_t limit = 30 * bytes - 1;
+    uint32_t *primes;
+    size_t np = base_primes(isqrt(limit), &primes);
+    sieve_range_wheel(o->bytes, bytes, limit, primes, np, NULL, NULL, bits + o->bytes);
+    free(primes);
+
+    o->bits = bits;
+    o->bytes = bytes;
+}
+
+int prime_oracle_is_prime(prime_oracle *o, uint64_t n) {
+    int bit = wheel_bit[n % 30];
+    if (bit < 0)                                      // multiplo di 2, 3 o 5
+        return n == 2 || n == 3 || n == 5;
+    if (n / 30 >= o->bytes)
+        prime_oracle_extend(o, n);
+    return (o->bits[n / 30] >> bit) & 1;
+}
+
+// —— Miller-Rabin deterministico a 64 bit ——
+// Aritmetica di Montgomery: x -> x*R mod n con R = 2^64, cosi' ogni riduzione modulo n
+// diventa due moltiplicazioni e una sottrazione invece di una divisione a 128 bit.
+
+// Primi dispari piccoli con inverso modulo 2^64 e floor((2^64-1)/p): n e' multiplo di p
+// se e solo se n * inv <= lim, una moltiplicazione invece di una divisione.
+static const struct { uint64_t p, inv, lim; } small_primes[] = {
+    {3ULL, 0xAAAAAAAAAAAAAAABULL, 0x5555555555555555ULL},
+    {5ULL, 0xCCCCCCCCCCCCCCCDULL, 0x3333333333333333ULL},
+    {7ULL, 0x6DB6DB6DB6DB6DB7ULL, 0x2492492492492492ULL},
+    {11ULL, 0x2E8BA2E8BA2E8BA3ULL, 0x1745D1745D1745D1ULL},
+    {13ULL, 0x4EC4EC4EC4EC4EC5ULL, 0x13B13B13B13B13B1ULL},
+    {17ULL, 0xF0F0F0F0F0F0F0F1ULL, 0x0F0F0F0F0F0F0F0FULL},
+    {19ULL, 0x86BCA1AF286BCA1BULL, 0x0D79435E50D79435ULL},
+    {23ULL, 0xD37A6F4DE9BD37A7ULL, 0x0B21642C8590B216ULL},
+    {29ULL, 0x34F72C234F72C235ULL, 0x08D3DCB08D3DCB08ULL},
+    {31ULL, 0xEF7BDEF7BDEF7BDFULL, 0x0842108421084210ULL},
+    {37ULL, 0x14C1BACF914C1BADULL, 0x06EB3E45306EB3E4ULL},
+    {41ULL, 0x8F9C18F9C18F9C19ULL, 0x063E7063E7063E70ULL},
+    {43ULL, 0x82FA0BE82FA0BE83ULL, 0x05F417D05F417D05ULL},
+    {47ULL, 0x51B3BEA3677D46CFULL, 0x0572620AE4C415C9ULL},
+    {53ULL, 0x21CFB2B78C13521DULL, 0x04D4873ECADE304DULL},
+    {59ULL, 0xCBEEA4E1A08AD8F3ULL, 0x0456C797DD49C341ULL},
+    {61ULL, 0x4FBCDA3AC10C9715ULL, 0x04325C53EF368EB0ULL},
+    {67ULL, 0xF0B7672A07A44C6BULL, 0x03D226357E16ECE5ULL},
+    {71ULL, 0x193D4BB7E327A977ULL, 0x039B0AD12073615AULL},
+    {73ULL, 0x7E3F1F8FC7E3F1F9ULL, 0x0381C0E070381C0EULL},
+    {79ULL, 0x9B8B577E613716AFULL, 0x033D91D2A2067B23ULL},
+    {83ULL, 0xA3784A062B2E43DBULL, 0x03159721ED7E7534ULL},
+    {89ULL, 0xF47E8FD1FA3F47E9ULL, 0x02E05C0B81702E05ULL},
+    {97ULL, 0xA3A0FD5C5F02A3A1ULL, 0x02A3A0FD5C5F02A3ULL},
+};
+#define N_SMALL_PRIMES (sizeof(small_primes) / sizeof(small_primes[0]))
+
+// Basi che rendono il test esatto per ogni n < 2^64 (Jim Sinclair) e per n < 2^32
+static const uint64_t witnesses64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+static const uint64_t witnesses32[] = {2, 7, 61};
+
+typedef struct {
+    uint64_t n, ninv;   // ninv = n^-1 mod 2^64
+    uint64_t one, mone; // 1 e n-1 in forma di Montgomery
+    uint64_t r2;        // R^2 mod n, per convertire in forma di Montgomery
+} Mont;
+
+static inline uint64_t mont_mul(uint64_t a, uint64_t b, uint64_t n, uint64_t ninv) {
+    __uint128_t t = (__uint128_t)a * b;
+    uint64_t lo = (uint64_t)t, hi = (uint64_t)(t >> 64);
+    uint64_t m = lo * ninv;                           // t - m*n e' divisibile per 2^64
+    uint64_t mn = (uint64_t)(((__uint128_t)m * n) >> 64);
+    return hi >= mn ? hi - mn : hi - mn + n;
+}
+
+static void mont_init(Mont *M, uint64_t n) {
+    uint64_t inv = n;                                 // n*n = 1 mod 8: 3 bit esatti
+    for (int i = 0; i < 5; i++)
+        inv *= 2 - n * inv;                           // Newton: raddoppia i bit esatti
+    M->n = n;
+    M->ninv = inv;
+    M->one = (0 - n) % n;                             // R mod n
+    M->r2 = (uint64_t)((__uint128_t)M->one * M->one % n);
+    M->mone = n - M->one;
+}
+
+// Un round di Miller-Rabin con base a (n - 1 = d * 2^s): 1 se n e' probabile primo
+static int mr_round(const Mont *M, uint64_t a, uint64_t d, int s) {
+    a %= M->n;
+    if (a == 0)
+        return 1;
+    uint64_t base = mont_mul(a, M->r2, M->n, M->ninv);
+    uint64_t x = M->one;
+    for (uint64_t e = d; e; e >>= 1) {
+        if (e & 1)
+            x = mont_mul(x, base, M->n, M->ninv);
+        base = mont_mul(base, base, M->n, M->ninv);
+    }
+    if (x == M->one || x == M->mone)
+        return 1;
+    for (int i = 1; i < s; i++) {
+        x = mont_mul(x, x, M->n, M->ninv);
+        if (x == M->mone)
+            return 1;
+    }
+    return 0;
+}
+
+// Filtro con i primi piccoli: 1 = primo, 0 = composto, -1 = serve Miller-Rabin
+static int small_filter(uint64_t n) {
+    if (n < 2)
+        return 0;
+    if (n % 2 == 0)
+        return n == 2;
+    for (size_t i = 0; i < N_SMALL_PRIMES; i++) {
+        if (n * small_primes[i].inv <= small_primes[i].lim)
+            return n == small_primes[i].p;
+    }
+    return n < 101 * 101 ? 1 : -1;                    // nessun fattore <= 97 e n < 101^2
+}
+
+static void mr_setup(uint64_t n, Mont *M, uint64_t *d, int *s) {
+    mont_init(M, n);
+    *d = n - 1;
+    *s = __builtin_ctzll(*d);
+    *d >>= *s;
+}
+
+static const uint64_t *mr_witnesses(uint64_t n, size_t *nw) {
+    if (n >> 32) {
+        *nw = sizeof(witnesses64) / sizeof(uint64_t);
+        return witnesses64;
+    }
+    *nw = sizeof(witnesses32) / sizeof(uint64_t);
+    return witnesses32;
+}
+
+int is_prime_u64(uint64_t n) {
+    int f = small_filter(n);
+    if (f >= 0)
+        return f;
+
+    Mont M;
+    uint64_t d;
+    int s;
+    mr_setup(n, &M, &d, &s);
+
+    size_t nw;
+    const uint64_t *w = mr_witnesses(n, &nw);
+    for (size_t i = 0; i < nw; i++)
+        if (!mr_round(&M, w[i], d, s))
+            return 0;
+    return 1;
+}
+
+// Test su BATCH_LANES candidati insieme: per ogni base le esponenziazioni dei vari
+// candidati sono catene di moltiplicazioni indipendenti, scritte come cicli sulle
+// corsie senza salti dipendenti dai dati, cosi' la CPU le sovrappone nella pipeline.
+// Ci arrivano solo i candidati che hanno gia' superato la base 2 (quasi tutti primi),
+// quindi tutte le corsie fanno le stesse basi restanti senza lavoro sprecato.
+#define BATCH_LANES 4
+
+static void mr_lanes(const uint64_t *n, uint8_t *out, int lanes) {
+    Mont M[BATCH_LANES];
+    uint64_t d[BATCH_LANES];
+    int s[BATCH_LANES], alive[BATCH_LANES], big = 0;
+
+    for (int l = 0; l < lanes; l++) {
+        mr_setup(n[l], &M[l], &d[l], &s[l]);
+        alive[l] = 1;
+        big |= n[l] >> 32 != 0;
+    }
+    size_t nw;
+    const uint64_t *w = mr_witnesses(big ? UINT64_MAX : 0, &nw);
+
+    for (size_t i = 1; i < nw; i++) {                 // la base 2 (w[0]) e' gia' stata fatta
+        uint64_t x[BATCH_LANES], base[BATCH_LANES];
+        int skip[BATCH_LANES];
+        int maxbits = 0;
+
+        for (int l = 0; l < lanes; l++) {
+            uint64_t a = w[i] % n[l];
+            skip[l] = !alive[l] || a == 0;            // base multipla di n: round superato
+            base[l] = mont_mul(a, M[l].r2, M[l].n, M[l].ninv);
+            x[l] = M[l].one;
+            int bits = 64 - __builtin_clzll(d[l]);
+            maxbits = bits > maxbits ? bits : maxbits;
+        }
+        // esponenziazione binaria: stessa sequenza di operazioni in tutte le corsie
+        for (int b = 0; b < maxbits; b++) {
+            for (int l = 0; l < lanes; l++) {
+                uint64_t y = mont_mul(x[l], base[l], M[l].n, M[l].ninv);
+                x[l] = (d[l] >> b) & 1 ? y : x[l];
+                base[l] = mont_mul(base[l], base[l], M[l].n, M[l].ninv);
+            }
+        }
+        for (int l = 0; l < lanes; l++) {
+            if (skip[l])
+                continue;
+            int ok = x[l] == M[l].one || x[l] == M[l].mone;
+            for (int r = 1; r < s[l] && !ok; r++) {
+                x[l] = mont_mul(x[l], x[l], M[l].n, M[l].ninv);
+                ok = x[l] == M[l].mone;
+            }
+            alive[l] = ok;
+        }
+    }
+    for (int l = 0; l < lanes; l++)
+        out[l] = (uint8_t)alive[l];
+}
+
+void is_prime_batch(const uint64_t *n, uint8_t *out, size_t count) {
+    uint64_t lane_n[BATCH_LANES];
+    size_t lane_idx[BATCH_LANES];
+    uint8_t lane_out[BATCH_LANES];
+    int lanes = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        // filtro: primi piccoli e poi la sola base 2, che scarta quasi tutti i composti
+        int f = small_filter(n[i]);
+        if (f < 0) {
+            Mont M;
+            uint64_t d;
+            int s;
+            mr_setup(n[i], &M, &d, &s);
+            f = mr_round(&M, 2, d, s) ? -1 : 0;
+        }
+        if (f >= 0) {
+            out[i] = (uint8_t)f;
+            continue;
+        }
+        lane_n[lanes] = n[i];
+        lane_idx[lanes++] = i;
+        if (lanes == BATCH_LANES) {
+            mr_lanes(lane_n, lane_out, lanes);
+            for (int l = 0; l < lanes; l++)
+                out[lane_idx[l]] = lane_out[l];
+            lanes = 0;
+        }
+    }
+    if (lanes) {
+        mr_lanes(lane_n, lane_out, lanes);
+        for (int l = 0; l < lanes; l++)
+            out[lane_idx[l]] = lane_out[l];
+    }
+}
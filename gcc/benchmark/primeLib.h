@@ -0,0 +1,92 @@
+#ifndef PRIMELIB_H
+#define PRIMELIB_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Funzione chiamata a ogni segmento con i primi trovati, in ordine crescente.
+// Il buffer viene riusato al segmento successivo: va copiato se serve dopo.
+typedef void (*prime_sink)(const uint64_t *primes, size_t count, void *ctx);
+
+// Rappresentazione del segmento usata dai crivelli:
+//   SIEVE_BYTE    -> un byte per numero dispari
+//   SIEVE_WHEEL30 -> solo i resti coprimi con 30, un bit per candidato (8 candidati = 30 numeri
+//                    per byte): circa 15 volte meno memoria e conteggio con popcount (default)
+typedef enum { SIEVE_BYTE, SIEVE_WHEEL30 } sieve_backend;
+
+void sieve_set_backend(sieve_backend b);
+sieve_backend sieve_get_backend(void);
+
+// —— Crivello segmentato ——
+/** Primi dispari <= limit (crivello semplice, usato per i primi base fino a sqrt(N)).
+    Restituisce quanti sono e li scrive in *out (da liberare con free). Servono limit / 16
+    byte temporanei piu' 4 byte per primo: per limit = 2^32 (N vicino a 2^64) circa 1.2 GB
+    di picco e 0.8 GB per la tabella finale. */
+size_t base_primes(uint64_t limit, uint32_t **out);
+
+/** Conta i primi <= limit con un crivello a segmenti grandi quanto la cache L1.
+    La memoria usata e' O(sqrt(limit)). Se sink != NULL riceve i primi segmento per segmento. */
+uint64_t sieve_count(uint64_t limit, prime_sink sink, void *ctx);
+
+/** Come sieve_count ma divide l'intervallo in blocchi di segmenti tra i thread OpenMP
+    (compilare con -fopenmp). Primi base condivisi, conteggi locali sommati alla fine. */
+uint64_t sieve_count_parallel(uint64_t limit);
+
+/** pi(x): numero di primi <= x senza enumerarli (Lucy_Hedgehog, O(x^(3/4)) tempo e
+    O(sqrt(x)) memoria). Con -fopenmp ogni passo di aggiornamento e' diviso tra i thread. */
+uint64_t prime_count(uint64_t x);
+
+// —— Iteratore sui primi ——
+// Primi di [lo, hi] in ordine crescente, un segmento della ruota mod 30 alla volta.
+// Tutta la memoria si alloca in prime_iter_init: next e fill non allocano mai. Per ogni primo
+// base fino a sqrt(hi) servono 76 byte (il primo e 8 progressioni della ruota): circa 6 MB per
+// hi = 10^12, 4 GB per hi = 10^18 e 15 GB per hi vicino a 2^64 (203 milioni di primi base).
+struct wheel_cursor;
+
+typedef struct {
+    uint64_t lo, hi;
+    int small;                      // quanti fra 2, 3, 5 sono gia' stati considerati
+    uint64_t unit, end;             // prossimo byte della ruota da crivellare, fine (esclusa)
+    uint8_t *seg;                   // segmento corrente: byte [seg_lo, seg_lo + seg_len)
+    uint64_t seg_lo;
+    size_t seg_len, pos;            // pos: prossimo byte da leggere
+    uint64_t base;                  // 30 * byte corrente
+    unsigned bits;                  // bit (primi) non ancora restituiti del byte corrente
+    uint32_t *primes;               // primi base fino a sqrt(hi)
+    size_t np;
+    struct wheel_cursor *cur;
+} prime_iter;
+
+void prime_iter_init(prime_iter *it, uint64_t lo, uint64_t hi);
+void prime_iter_free(prime_iter *it);
+
+/** Prossimo primo dell'intervallo, 0 quando sono finiti. */
+uint64_t prime_iter_next(prime_iter *it);
+
+/** Scrive in buf fino a n primi successivi; restituisce quanti (0 = finiti). */
+size_t prime_iter_fill(prime_iter *it, uint64_t *buf, size_t n);
+
+// —— Oracolo di primalita' ——
+// Crivello condiviso che cresce su richiesta: ogni domanda e' la lettura di un bit.
+typedef struct {
+    uint8_t *bits;      // ruota mod 30: il byte b copre i numeri [30b, 30b+30)
+    uint64_t bytes;     // byte gia' crivellati
+} prime_oracle;
+
+void prime_oracle_init(prime_oracle *o);
+void prime_oracle_free(prime_oracle *o);
+
+/** 1 se n e' primo. Se n supera la parte gia' crivellata la tabella viene estesa
+    (almeno raddoppiata) crivellando solo la parte nuova. */
+int prime_oracle_is_prime(prime_oracle *o, uint64_t n);
+
+// —— Test di primalita' ——
+/** 1 se n e' primo. Miller-Rabin deterministico per tutti gli n a 64 bit
+    (aritmetica di Montgomery, filtro preliminare con i primi fino a 97). */
+int is_prime_u64(uint64_t n);
+
+/** out[i] = is_prime_u64(n[i]) per count candidati, elaborati a gruppi di 4. */
+void is_prime_batch(const uint64_t *n, uint8_t *out, size_t count);
+
+#endif // PRIMELIB_H
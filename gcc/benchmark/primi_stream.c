@@ -0,0 +1,64 @@
+// Compilazione: gcc -O2 [-fopenmp] primi_stream.c primeLib.c -o primi_stream
+#include <stdio.h> // input/output
+#include <stdlib.h> // exit
+#include <time.h> // clock_gettime
+#include "primeLib.h" // iteratore sui primi
+
+#define FILL_BUFFER 4096
+
+double tempo_reale(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Uso: ./primi_stream  -> chiede l'intervallo [lo, hi] e lo percorre con
+// prime_iter_next() e con prime_iter_fill(), confrontando con pi(x)
+int main(void) {
+    unsigned long long lo, hi;
+    printf("Inserire l'intervallo dei primi (lo hi): ");
+    if (scanf("%llu %llu", &lo, &hi) != 2) {
+        printf("Intervallo non valido\n");
+        return 1;
+    }
+
+    prime_iter it;
+    unsigned long long count_next = 0, sum_next = 0;
+    unsigned long long count_fill = 0, sum_fill = 0;
+
+    // un primo alla volta
+    double start = tempo_reale();
+    prime_iter_init(&it, lo, hi);
+    for (uint64_t p; (p = prime_iter_next(&it)) != 0;) {
+        count_next++;
+        sum_next += p;
+    }
+    prime_iter_free(&it);
+    double t_next = tempo_reale() - start;
+    printf("prime_iter_next: %llu primi in %f secondi (%.1f M primi/s)\n",
+           count_next, t_next, t_next > 0 ? count_next / t_next * 1e-6 : 0.0);
+
+    // a blocchi di FILL_BUFFER primi
+    uint64_t buf[FILL_BUFFER];
+    start = tempo_reale();
+    prime_iter_init(&it, lo, hi);
+    for (size_t n; (n = prime_iter_fill(&it, buf, FILL_BUFFER)) != 0;) {
+        count_fill += n;
+        for (size_t i = 0; i < n; i++)
+            sum_fill += buf[i];
+    }
+    prime_iter_free(&it);
+    double t_fill = tempo_reale() - start;
+    printf("prime_iter_fill: %llu primi in %f secondi (%.1f M primi/s)\n",
+           count_fill, t_fill, t_fill > 0 ? count_fill / t_fill * 1e-6 : 0.0);
+
+    // verifica con pi(hi) - pi(lo - 1), che non enumera i primi
+    unsigned long long atteso = lo <= hi ? prime_count(hi) - (lo > 0 ? prime_count(lo - 1) : 0) : 0;
+    if (count_next == atteso && count_fill == atteso && sum_next == sum_fill) {
+        printf("Risultato corretto: %llu primi in [%llu, %llu] (somma mod 2^64 = %llu)\n", atteso, lo, hi, sum_next);
+    } else {
+        printf("ERRORE: next=%llu, fill=%llu, pi(x)=%llu\n", count_next, count_fill, atteso);
+    }
+
+    return 0;
+}
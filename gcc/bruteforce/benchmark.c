@@ -25,8 +25,9 @@ int main()
         }
     }
 
-    // Inizia la misura del tempo
-    clock_t start = clock();
+    // Inizia la misura del tempo (tempo reale, non tempo CPU)
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
 
     // Moltiplicazione delle matrici: C = A * B
     for (int i = 0; i < DIM; i++)
@@ -42,9 +43,10 @@ int main()
     }
 
     // Termina la misura del tempo
-    clock_t end = clock();
-    double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("Tempo impiegato per la moltiplicazione delle matrici: %.3f secondi\n", time_spent);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double time_spent = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("Tempo impiegato per la moltiplicazione delle matrici: %.3f secondi (%.2f GFLOP/s)\n",
+           time_spent, 2.0 * DIM * DIM * DIM / time_spent * 1e-9);
 
     return 0;
 }
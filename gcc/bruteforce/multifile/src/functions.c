@@ -1,29 +1,379 @@
 // functions.c
 #include "functions.h"
+#include "gemm_internal.h"
+#include <string.h>
+#include <sys/mman.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
 
-double A[SIZE][SIZE], B[SIZE][SIZE], C[SIZE][SIZE];
+typedef void (*kernel_fn)(size_t kc, const double *Ap, const double *Bp,
+                          double *C, size_t ldc, double alpha, double beta);
 
-void initialize_matrices() {
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            A[i][j] = (double)rand() / RAND_MAX;
-            B[i][j] = (double)rand() / RAND_MAX;
-            C[i][j] = 0.0;
+typedef struct {
+    const char *name;   // nome usato anche da GEMM_ISA
+    int mr, nr;         // dimensioni della tile in registri
+    kernel_fn fn;
+} Kernel;
+
+// Sopra questa soglia la matrice viene allocata con mmap e marcata MADV_HUGEPAGE:
+// pagine da 2 MB riducono di 512 volte le voci TLB necessarie a percorrerla.
+#define HUGE_PAGE (2UL * 1024 * 1024)
+
+int matrix_init(Matrix *m, size_t rows, size_t cols) {
+    m->rows = m->cols = m->stride = m->bytes = 0;
+    m->huge = 0;
+    m->data = NULL;
+
+    // dimensioni il cui numero di byte (arrotondato alla huge page) non sta in size_t
+    if (cols > SIZE_MAX / sizeof(double) - 16)
+        return -1;
+
+    // riga arrotondata a 8 double (64 byte); se il passo e' un multiplo di 4 KB
+    // si aggiunge una linea di cache per evitare che le righe collidano negli stessi set
+    size_t stride = (cols + 7) & ~(size_t)7;
+    if (stride > 0 && (stride * sizeof(double)) % 4096 == 0)
+        stride += 8;
+    if (stride > 0 && rows > (SIZE_MAX - HUGE_PAGE) / sizeof(double) / stride)
+        return -1;
+
+    m->rows = rows;
+    m->cols = cols;
+    m->stride = stride;
+    m->bytes = rows * stride * sizeof(double);
+
+    if (m->bytes >= HUGE_PAGE) {
+        m->bytes = (m->bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        void *p = mmap(NULL, m->bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+            madvise(p, m->bytes, MADV_HUGEPAGE);
+#endif
+            m->data = p;
+            m->huge = 1;
+            return 0;
+        }
+    }
+
+    m->bytes = (m->bytes + 63) & ~(size_t)63;
+    m->data = aligned_alloc(64, m->bytes > 0 ? m->bytes : 64);
+    return m->data ? 0 : -1;
+}
+
+void matrix_free(Matrix *m) {
+    if (m->huge)
+        munmap(m->data, m->bytes);
+    else
+        free(m->data);
+    m->data = NULL;
+    m->rows = m->cols = m->stride = m->bytes = 0;
+}
+
+void initialize_matrices(Matrix *A, Matrix *B, Matrix *C) {
+    for (size_t i = 0; i < A->rows; i++)
+        for (size_t j = 0; j < A->cols; j++)
+            MAT(A, i, j) = (double)rand() / RAND_MAX;
+    for (size_t i = 0; i < B->rows; i++)
+        for (size_t j = 0; j < B->cols; j++)
+            MAT(B, i, j) = (double)rand() / RAND_MAX;
+    for (size_t i = 0; i < C->rows; i++)
+        memset(&MAT(C, i, 0), 0, C->cols * sizeof(double));
+}
+
+int multiply_matrices(const Matrix *A, const Matrix *B, Matrix *C) {
+    if (A->cols != B->rows || C->rows != A->rows || C->cols != B->cols) {
+        printf("Dimensioni incompatibili: (%zux%zu) * (%zux%zu) -> (%zux%zu)\n",
+               A->rows, A->cols, B->rows, B->cols, C->rows, C->cols);
+        return -1;
+    }
+    // C += A * B (stesso risultato del vecchio ciclo i-j-k)
+    gemm(A->rows, B->cols, A->cols, 1.0, A->data, A->stride, B->data, B->stride, 1.0, C->data, C->stride);
+    return 0;
+}
+
+// Tempo reale in secondi (CLOCK_MONOTONIC): a differenza di clock() non somma
+// il tempo CPU dei thread e non risente delle modifiche all'orologio di sistema.
+double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Scrittura finale di una tile: C = alpha * acc + beta * C (C non si legge se beta == 0)
+#define STORE_TILE(c, ldc, acc, alpha, beta, MR, NR)                                   \
+    for (int r = 0; r < (MR); r++)                                                      \
+        for (int j = 0; j < (NR); j++)                                                  \
+            (c)[r * (ldc) + j] = (beta) == 0.0 ? (alpha) * (acc)[r][j]                  \
+                                 : (alpha) * (acc)[r][j] + (beta) * (c)[r * (ldc) + j];
+
+// Micro-kernel generico 4x8 in C puro: con -O3 il compilatore lo vettorizza
+// secondo i flag di compilazione. E' il ripiego per CPU non x86.
+static void kernel_generic(size_t kc, const double *Ap, const double *Bp,
+                           double *C, size_t ldc, double alpha, double beta) {
+    double acc[4][8] = {{0.0}};
+
+    for (size_t k = 0; k < kc; k++) {
+        for (int r = 0; r < 4; r++) {
+            double a = Ap[r];
+            for (int c = 0; c < 8; c++)
+                acc[r][c] += a * Bp[c];
+        }
+        Ap += 4;
+        Bp += 8;
+    }
+    STORE_TILE(C, ldc, acc, alpha, beta, 4, 8)
+}
+
+#ifdef GEMM_X86
+// SSE2 4x4: 8 accumulatori __m128d (2 per riga). Disponibile su ogni CPU x86-64.
+__attribute__((target("sse2")))
+static void kernel_sse2(size_t kc, const double *Ap, const double *Bp,
+                        double *C, size_t ldc, double alpha, double beta) {
+    __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+    __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+    __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+    __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+
+    for (size_t k = 0; k < kc; k++) {
+        __m128d b0 = _mm_load_pd(Bp), b1 = _mm_load_pd(Bp + 2);
+        __m128d a;
+        a = _mm_set1_pd(Ap[0]); c00 = _mm_add_pd(c00, _mm_mul_pd(a, b0)); c01 = _mm_add_pd(c01, _mm_mul_pd(a, b1));
+        a = _mm_set1_pd(Ap[1]); c10 = _mm_add_pd(c10, _mm_mul_pd(a, b0)); c11 = _mm_add_pd(c11, _mm_mul_pd(a, b1));
+        a = _mm_set1_pd(Ap[2]); c20 = _mm_add_pd(c20, _mm_mul_pd(a, b0)); c21 = _mm_add_pd(c21, _mm_mul_pd(a, b1));
+        a = _mm_set1_pd(Ap[3]); c30 = _mm_add_pd(c30, _mm_mul_pd(a, b0)); c31 = _mm_add_pd(c31, _mm_mul_pd(a, b1));
+        Ap += 4;
+        Bp += 4;
+    }
+
+    double acc[4][4];
+    _mm_storeu_pd(&acc[0][0], c00); _mm_storeu_pd(&acc[0][2], c01);
+    _mm_storeu_pd(&acc[1][0], c10); _mm_storeu_pd(&acc[1][2], c11);
+    _mm_storeu_pd(&acc[2][0], c20); _mm_storeu_pd(&acc[2][2], c21);
+    _mm_storeu_pd(&acc[3][0], c30); _mm_storeu_pd(&acc[3][2], c31);
+    STORE_TILE(C, ldc, acc, alpha, beta, 4, 4)
+}
+
+// AVX2 + FMA 6x8: 12 accumulatori ymm + 2 per B + 1 broadcast di A = 15 dei 16 registri.
+__attribute__((target("avx2,fma")))
+static void kernel_avx2(size_t kc, const double *Ap, const double *Bp,
+                        double *C, size_t ldc, double alpha, double beta) {
+    __m256d c[6][2];
+    for (int r = 0; r < 6; r++)
+        c[r][0] = c[r][1] = _mm256_setzero_pd();
+
+    for (size_t k = 0; k < kc; k++) {
+        __m256d b0 = _mm256_load_pd(Bp), b1 = _mm256_load_pd(Bp + 4);
+        for (int r = 0; r < 6; r++) {
+            __m256d a = _mm256_broadcast_sd(Ap + r);
+            c[r][0] = _mm256_fmadd_pd(a, b0, c[r][0]);
+            c[r][1] = _mm256_fmadd_pd(a, b1, c[r][1]);
+        }
+        Ap += 6;
+        Bp += 8;
+    }
+
+    __m256d va = _mm256_set1_pd(alpha), vb = _mm256_set1_pd(beta);
+    for (int r = 0; r < 6; r++) {
+        double *cr = C + r * ldc;
+        if (beta == 0.0) {
+            _mm256_storeu_pd(cr, _mm256_mul_pd(va, c[r][0]));
+            _mm256_storeu_pd(cr + 4, _mm256_mul_pd(va, c[r][1]));
+        } else {
+            _mm256_storeu_pd(cr, _mm256_fmadd_pd(vb, _mm256_loadu_pd(cr), _mm256_mul_pd(va, c[r][0])));
+            _mm256_storeu_pd(cr + 4, _mm256_fmadd_pd(vb, _mm256_loadu_pd(cr + 4), _mm256_mul_pd(va, c[r][1])));
         }
     }
 }
 
-void multiply_matrices() {
-    for (int i = 0; i < SIZE; i++) {
-        for (int j = 0; j < SIZE; j++) {
-            for (int k = 0; k < SIZE; k++) {
-                C[i][j] += A[i][k] * B[k][j];
+// AVX-512 8x16: 16 accumulatori zmm (su 32 registri disponibili).
+__attribute__((target("avx512f")))
+static void kernel_avx512(size_t kc, const double *Ap, const double *Bp,
+                          double *C, size_t ldc, double alpha, double beta) {
+    __m512d c[8][2];
+    for (int r = 0; r < 8; r++)
+        c[r][0] = c[r][1] = _mm512_setzero_pd();
+
+    for (size_t k = 0; k < kc; k++) {
+        __m512d b0 = _mm512_load_pd(Bp), b1 = _mm512_load_pd(Bp + 8);
+        for (int r = 0; r < 8; r++) {
+            __m512d a = _mm512_set1_pd(Ap[r]);
+            c[r][0] = _mm512_fmadd_pd(a, b0, c[r][0]);
+            c[r][1] = _mm512_fmadd_pd(a, b1, c[r][1]);
+        }
+        Ap += 8;
+        Bp += 16;
+    }
+
+    __m512d va = _mm512_set1_pd(alpha), vb = _mm512_set1_pd(beta);
+    for (int r = 0; r < 8; r++) {
+        double *cr = C + r * ldc;
+        if (beta == 0.0) {
+            _mm512_storeu_pd(cr, _mm512_mul_pd(va, c[r][0]));
+            _mm512_storeu_pd(cr + 8, _mm512_mul_pd(va, c[r][1]));
+        } else {
+            _mm512_storeu_pd(cr, _mm512_fmadd_pd(vb, _mm512_loadu_pd(cr), _mm512_mul_pd(va, c[r][0])));
+            _mm512_storeu_pd(cr + 8, _mm512_fmadd_pd(vb, _mm512_loadu_pd(cr + 8), _mm512_mul_pd(va, c[r][1])));
+        }
+    }
+}
+#endif
+
+static const Kernel kernels[] = {
+#ifdef GEMM_X86
+    {"avx512", 8, 16, kernel_avx512},
+    {"avx2",   6, 8,  kernel_avx2},
+    {"sse2",   4, 4,  kernel_sse2},
+#endif
+    {"generic", 4, 8, kernel_generic},
+};
+#define N_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+static int kernel_supported(const Kernel *k) {
+#ifdef GEMM_X86
+    if (strcmp(k->name, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+    if (strcmp(k->name, "avx2") == 0)   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (strcmp(k->name, "sse2") == 0)   return __builtin_cpu_supports("sse2");
+#endif
+    return 1;
+}
+
+// Sceglie il micro-kernel una volta sola: il migliore supportato dalla CPU (CPUID),
+// oppure quello imposto con la variabile d'ambiente GEMM_ISA (avx512, avx2, sse2, generic).
+static const Kernel *select_kernel(void) {
+    static const Kernel *selected = NULL;
+    if (selected)
+        return selected;
+
+#ifdef GEMM_X86
+    __builtin_cpu_init();
+#endif
+    const char *forced = getenv("GEMM_ISA");
+    if (forced && *forced) {
+        size_t i = 0;
+        while (i < N_KERNELS && strcmp(kernels[i].name, forced) != 0)
+            i++;
+        if (i == N_KERNELS)
+            fprintf(stderr, "GEMM_ISA=%s sconosciuta, uso il rilevamento automatico\n", forced);
+        else if (!kernel_supported(&kernels[i]))
+            fprintf(stderr, "GEMM_ISA=%s non supportata da questa CPU, uso il rilevamento automatico\n", forced);
+        else
+            return selected = &kernels[i];
+    }
+
+    for (size_t i = 0; i < N_KERNELS; i++) {
+        if (kernel_supported(&kernels[i]))
+            return selected = &kernels[i];
+    }
+    return selected = &kernels[N_KERNELS - 1];
+}
+
+const char *gemm_isa(void) {
+    return select_kernel()->name;
+}
+
+// Buffer di impacchettamento: quello di A e' privato di ogni thread, quello di B e' del
+// thread che chiama gemm() ed e' condiviso dal team. Restano allocati tra una chiamata e
+// l'altra (il team OpenMP e' persistente) finche' non si chiama gemm_release_buffers().
+// Il buffer di A viene toccato per primo dal thread che lo usa: con OMP_PROC_BIND=close/spread
+// la policy first-touch di Linux lo mette sul nodo NUMA del core su cui gira il thread.
+// Ogni buffer allocato finisce anche in una lista globale, cosi' gemm_release_buffers() li
+// libera tutti qualunque sia stato il numero di thread; il contatore di generazione dice ai
+// thread che i loro puntatori non sono piu' validi.
+static double *thread_Ap = NULL, *thread_Bp = NULL;
+static unsigned thread_gen = 0;
+#pragma omp threadprivate(thread_Ap, thread_Bp, thread_gen)
+
+static double **all_buffers = NULL;
+static size_t n_buffers = 0, cap_buffers = 0;
+static unsigned buffers_gen = 1;
+
+static double *thread_buffer(double **buf, size_t n) {
+    if (thread_gen != buffers_gen) {
+        // buffer gia' liberati da gemm_release_buffers()
+        thread_Ap = thread_Bp = NULL;
+        thread_gen = buffers_gen;
+    }
+    if (!*buf) {
+        *buf = aligned_alloc(64, sizeof(double) * n);
+        if (!*buf) {
+            printf("Errore di allocazione memoria\n");
+            exit(1);
+        }
+        memset(*buf, 0, sizeof(double) * n);
+        #pragma omp critical(gemm_buffers)
+        {
+            if (n_buffers == cap_buffers) {
+                cap_buffers = cap_buffers ? 2 * cap_buffers : 16;
+                all_buffers = realloc(all_buffers, cap_buffers * sizeof(double *));
+                if (!all_buffers) {
+                    printf("Errore di allocazione memoria\n");
+                    exit(1);
+                }
             }
+            all_buffers[n_buffers++] = *buf;
         }
     }
+    return *buf;
 }
 
-void print_execution_time(clock_t start, clock_t end) {
-    double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("Tempo impiegato per la moltiplicazione delle matrici: %.3f secondi\n", time_spent);
+void *gemm_buffer_A(void) {
+    return thread_buffer(&thread_Ap, MC * KC);
+}
+
+void *gemm_buffer_B(void) {
+    return thread_buffer(&thread_Bp, KC * NC);
+}
+
+void gemm_release_buffers(void) {
+    for (size_t i = 0; i < n_buffers; i++)
+        free(all_buffers[i]);
+    free(all_buffers);
+    all_buffers = NULL;
+    n_buffers = cap_buffers = 0;
+    buffers_gen++;
+}
+
+static int gemm_threads = 0; // 0 = non ancora impostato
+
+void gemm_set_threads(int n) {
+    gemm_threads = n > 0 ? n : 1;
+}
+
+int gemm_get_threads(void) {
+    if (gemm_threads == 0) {
+        const char *env = getenv("GEMM_THREADS");
+        if (env && atoi(env) > 0)
+            gemm_threads = atoi(env);
+        else
+#ifdef _OPENMP
+            gemm_threads = omp_get_max_threads();
+#else
+            gemm_threads = 1;
+#endif
+    }
+    return gemm_threads;
+}
+
+// —— Schema a blocchi (gemm_tmpl.h) per i double ——
+#define GEMM_T double
+#define GEMM_IN double
+#define GEMM_LOAD(x) (x)
+#define GEMM_NOME f64
+#define GEMM_KERNEL Kernel
+#include "gemm_tmpl.h"
+#undef GEMM_T
+#undef GEMM_IN
+#undef GEMM_LOAD
+#undef GEMM_NOME
+#undef GEMM_KERNEL
+
+void gemm(size_t M, size_t N, size_t K, double alpha,
+          const double *A, size_t lda,
+          const double *B, size_t ldb,
+          double beta, double *C, size_t ldc) {
+    gemm_blocchi_f64(select_kernel(), M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
 }
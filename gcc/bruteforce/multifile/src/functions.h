@@ -4,14 +4,76 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <time.h>
 
-#define SIZE 1000
+// Matrice row-major con dimensioni decise a runtime.
+// Ogni riga inizia a un indirizzo allineato a 64 byte: stride (in elementi) e' >= cols.
+typedef struct Matrix {
+    size_t rows, cols;
+    size_t stride;      // distanza in elementi tra l'inizio di due righe
+    double *data;
+    size_t bytes;       // byte effettivamente allocati
+    int huge;           // 1 se allocata con mmap + transparent huge pages
+} Matrix;
 
-extern double A[SIZE][SIZE], B[SIZE][SIZE], C[SIZE][SIZE];
+#define MAT(m, i, j) ((m)->data[(i) * (m)->stride + (j)])
 
-void initialize_matrices();
-void multiply_matrices();
-void print_execution_time(clock_t start, clock_t end);
+int matrix_init(Matrix *m, size_t rows, size_t cols);
+void matrix_free(Matrix *m);
+
+void initialize_matrices(Matrix *A, Matrix *B, Matrix *C);
+int multiply_matrices(const Matrix *A, const Matrix *B, Matrix *C);
+double wall_time(void);
+
+/*
+ * C = alpha * A * B + beta * C   (matrici row-major)
+ * A e' M x K con passo di riga lda, B e' K x N con passo ldb, C e' M x N con passo ldc.
+ * Con beta == 0 il contenuto iniziale di C viene ignorato.
+ */
+void gemm(size_t M, size_t N, size_t K, double alpha,
+          const double *A, size_t lda,
+          const double *B, size_t ldb,
+          double beta, double *C, size_t ldc);
+
+// Nome del micro-kernel scelto a runtime ("avx512", "avx2", "sse2" o "generic").
+// Si puo' forzare con la variabile d'ambiente GEMM_ISA.
+const char *gemm_isa(void);
+
+// Numero di thread usati da gemm() (compilando con -fopenmp).
+// Default: variabile d'ambiente GEMM_THREADS, altrimenti OMP_NUM_THREADS / numero di core.
+void gemm_set_threads(int n);
+int gemm_get_threads(void);
+
+// Libera i buffer di impacchettamento che gemm() tiene allocati tra una chiamata e l'altra
+// (uno per thread, anche di team piu' grandi di quello attuale). Va chiamata fuori da
+// regioni parallele; la chiamata successiva a gemm() li rialloca.
+void gemm_release_buffers(void);
+
+// —— Strassen-Winograd (strassen.c) ——
+// C = A * B (C viene sovrascritta). Ricorre finche' tutte le dimensioni superano la soglia,
+// poi usa gemm(). Soglia di default 1024, modificabile con strassen_set_cutoff() o STRASSEN_CUTOFF.
+int multiply_matrices_strassen(const Matrix *A, const Matrix *B, Matrix *C);
+void strassen_set_cutoff(size_t cutoff);
+size_t strassen_get_cutoff(void);
+
+// Confronta C (calcolata con Strassen) con il prodotto classico: restituisce l'errore
+// massimo assoluto e scrive in *bound il limite teorico di errore per Winograd.
+double strassen_check(const Matrix *A, const Matrix *B, const Matrix *C, double *bound);
+
+// —— Precisione ridotta (gemm_mixed.c) ——
+// Stessa interfaccia di gemm(): f32 puro e bfloat16 in ingresso con accumulo in float.
+void gemm_f32(size_t M, size_t N, size_t K, float alpha,
+              const float *A, size_t lda,
+              const float *B, size_t ldb,
+              float beta, float *C, size_t ldc);
+void gemm_bf16(size_t M, size_t N, size_t K, float alpha,
+               const uint16_t *A, size_t lda,
+               const uint16_t *B, size_t ldb,
+               float beta, float *C, size_t ldc);
+
+// Conversione float <-> bfloat16 (arrotondamento al pari piu' vicino)
+uint16_t float_to_bf16(float f);
+float bf16_to_float(uint16_t h);
 
 #endif // FUNCTIONS_H
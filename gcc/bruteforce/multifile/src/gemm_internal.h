@@ -0,0 +1,27 @@
+// gemm_internal.h
+// Parti comuni a gemm() (functions.c) e alle varianti in precisione ridotta (gemm_mixed.c):
+// dimensioni dei blocchi e buffer di impacchettamento. Non fa parte dell'interfaccia pubblica.
+#ifndef GEMM_INTERNAL_H
+#define GEMM_INTERNAL_H
+
+#include <stddef.h>
+
+// Dimensioni dei blocchi (in elementi, uguali per double e float):
+//   mr x nr  -> tile di C tenuta nei registri dal micro-kernel (dipende dall'ISA scelta)
+//   KC       -> pannello di A (mr x KC) + pannello di B (KC x nr) stanno in L1
+//   MC       -> blocco impacchettato di A (MC x KC) sta in L2
+//   NC       -> blocco impacchettato di B (KC x NC) sta in L2/L3, condiviso dai thread
+// MC e NC sono multipli di tutti gli mr/nr dei kernel, cosi' il padding non sfora i buffer.
+#define KC 256
+#define MC 96
+#define NC 1024
+#define MR_MAX 8
+#define NR_MAX 32
+
+// Buffer di impacchettamento da MC x KC (A) e KC x NC (B) elementi double: bastano anche
+// per i float. Il buffer di A e' privato del thread che chiama, quello di B va chiesto dal
+// thread che chiama gemm (fuori dalla regione parallela) e condiviso con il team.
+void *gemm_buffer_A(void);
+void *gemm_buffer_B(void);
+
+#endif // GEMM_INTERNAL_H
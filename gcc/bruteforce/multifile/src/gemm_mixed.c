@@ -0,0 +1,214 @@
+// gemm_mixed.c
+#include "functions.h"
+#include "gemm_internal.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
+
+// Varianti in precisione ridotta di gemm():
+//   gemm_f32  -> ingressi float, accumulo e uscita float
+//   gemm_bf16 -> ingressi bfloat16, accumulo e uscita float
+// Lo schema a blocchi e' quello di gemm() (gemm_tmpl.h). I bf16 vengono convertiti in float
+// durante l'impacchettamento: dalla memoria si leggono 2 byte per elemento invece di 8,
+// mentre il micro-kernel lavora sempre in float (16 elementi per registro AVX-512).
+
+// —— Conversioni bfloat16 ——
+// bf16 = i 16 bit alti di un float (segno, 8 bit di esponente, 7 di mantissa),
+// stessa scomposizione usata in virgola_mobile/float_lib.c.
+uint16_t float_to_bf16(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    if ((bits & 0x7FFFFFFF) > 0x7F800000)          // NaN: mantiene un bit di mantissa
+        return (uint16_t)((bits >> 16) | 0x0040);
+    bits += 0x7FFF + ((bits >> 16) & 1);           // arrotondamento al pari piu' vicino
+    return (uint16_t)(bits >> 16);
+}
+
+float bf16_to_float(uint16_t h) {
+    uint32_t bits = (uint32_t)h << 16;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// —— Micro-kernel float ——
+typedef void (*kernel_f32_fn)(size_t kc, const float *Ap, const float *Bp,
+                              float *C, size_t ldc, float alpha, float beta);
+
+typedef struct {
+    const char *name;
+    int mr, nr;
+    kernel_f32_fn fn;
+} KernelF32;
+
+static void kernel_f32_generic(size_t kc, const float *Ap, const float *Bp,
+                               float *C, size_t ldc, float alpha, float beta) {
+    float acc[4][16] = {{0.0f}};
+
+    for (size_t k = 0; k < kc; k++) {
+        for (int r = 0; r < 4; r++) {
+            float a = Ap[r];
+            for (int c = 0; c < 16; c++)
+                acc[r][c] += a * Bp[c];
+        }
+        Ap += 4;
+        Bp += 16;
+    }
+    for (int r = 0; r < 4; r++)
+        for (int c = 0; c < 16; c++)
+            C[r * ldc + c] = beta == 0.0f ? alpha * acc[r][c] : alpha * acc[r][c] + beta * C[r * ldc + c];
+}
+
+#ifdef GEMM_X86
+// SSE2 4x8: 8 accumulatori __m128 (2 per riga)
+__attribute__((target("sse2")))
+static void kernel_f32_sse2(size_t kc, const float *Ap, const float *Bp,
+                            float *C, size_t ldc, float alpha, float beta) {
+    __m128 c[4][2];
+    for (int r = 0; r < 4; r++)
+        c[r][0] = c[r][1] = _mm_setzero_ps();
+
+    for (size_t k = 0; k < kc; k++) {
+        __m128 b0 = _mm_load_ps(Bp), b1 = _mm_load_ps(Bp + 4);
+        for (int r = 0; r < 4; r++) {
+            __m128 a = _mm_set1_ps(Ap[r]);
+            c[r][0] = _mm_add_ps(c[r][0], _mm_mul_ps(a, b0));
+            c[r][1] = _mm_add_ps(c[r][1], _mm_mul_ps(a, b1));
+        }
+        Ap += 4;
+        Bp += 8;
+    }
+
+    __m128 va = _mm_set1_ps(alpha), vb = _mm_set1_ps(beta);
+    for (int r = 0; r < 4; r++) {
+        for (int h = 0; h < 2; h++) {
+            float *cr = C + r * ldc + 4 * h;
+            __m128 v = _mm_mul_ps(va, c[r][h]);
+            if (beta != 0.0f)
+                v = _mm_add_ps(v, _mm_mul_ps(vb, _mm_loadu_ps(cr)));
+            _mm_storeu_ps(cr, v);
+        }
+    }
+}
+
+// AVX2 + FMA 6x16: 12 accumulatori ymm
+__attribute__((target("avx2,fma")))
+static void kernel_f32_avx2(size_t kc, const float *Ap, const float *Bp,
+                            float *C, size_t ldc, float alpha, float beta) {
+    __m256 c[6][2];
+    for (int r = 0; r < 6; r++)
+        c[r][0] = c[r][1] = _mm256_setzero_ps();
+
+    for (size_t k = 0; k < kc; k++) {
+        __m256 b0 = _mm256_load_ps(Bp), b1 = _mm256_load_ps(Bp + 8);
+        for (int r = 0; r < 6; r++) {
+            __m256 a = _mm256_broadcast_ss(Ap + r);
+            c[r][0] = _mm256_fmadd_ps(a, b0, c[r][0]);
+            c[r][1] = _mm256_fmadd_ps(a, b1, c[r][1]);
+        }
+        Ap += 6;
+        Bp += 16;
+    }
+
+    __m256 va = _mm256_set1_ps(alpha), vb = _mm256_set1_ps(beta);
+    for (int r = 0; r < 6; r++) {
+        for (int h = 0; h < 2; h++) {
+            float *cr = C + r * ldc + 8 * h;
+            __m256 v = _mm256_mul_ps(va, c[r][h]);
+            if (beta != 0.0f)
+                v = _mm256_fmadd_ps(vb, _mm256_loadu_ps(cr), v);
+            _mm256_storeu_ps(cr, v);
+        }
+    }
+}
+
+// AVX-512 8x32: 16 accumulatori zmm
+__attribute__((target("avx512f")))
+static void kernel_f32_avx512(size_t kc, const float *Ap, const float *Bp,
+                              float *C, size_t ldc, float alpha, float beta) {
+    __m512 c[8][2];
+    for (int r = 0; r < 8; r++)
+        c[r][0] = c[r][1] = _mm512_setzero_ps();
+
+    for (size_t k = 0; k < kc; k++) {
+        __m512 b0 = _mm512_load_ps(Bp), b1 = _mm512_load_ps(Bp + 16);
+        for (int r = 0; r < 8; r++) {
+            __m512 a = _mm512_set1_ps(Ap[r]);
+            c[r][0] = _mm512_fmadd_ps(a, b0, c[r][0]);
+            c[r][1] = _mm512_fmadd_ps(a, b1, c[r][1]);
+        }
+        Ap += 8;
+        Bp += 32;
+    }
+
+    __m512 va = _mm512_set1_ps(alpha), vb = _mm512_set1_ps(beta);
+    for (int r = 0; r < 8; r++) {
+        for (int h = 0; h < 2; h++) {
+            float *cr = C + r * ldc + 16 * h;
+            __m512 v = _mm512_mul_ps(va, c[r][h]);
+            if (beta != 0.0f)
+                v = _mm512_fmadd_ps(vb, _mm512_loadu_ps(cr), v);
+            _mm512_storeu_ps(cr, v);
+        }
+    }
+}
+#endif
+
+static const KernelF32 kernels_f32[] = {
+#ifdef GEMM_X86
+    {"avx512", 8, 32, kernel_f32_avx512},
+    {"avx2",   6, 16, kernel_f32_avx2},
+    {"sse2",   4, 8,  kernel_f32_sse2},
+#endif
+    {"generic", 4, 16, kernel_f32_generic},
+};
+#define N_KERNELS_F32 (sizeof(kernels_f32) / sizeof(kernels_f32[0]))
+
+// Stessa ISA scelta per il gemm in double (CPUID o GEMM_ISA)
+static const KernelF32 *select_kernel_f32(void) {
+    const char *isa = gemm_isa();
+    for (size_t i = 0; i < N_KERNELS_F32; i++) {
+        if (strcmp(kernels_f32[i].name, isa) == 0)
+            return &kernels_f32[i];
+    }
+    return &kernels_f32[N_KERNELS_F32 - 1];
+}
+
+// —— Schema a blocchi (gemm_tmpl.h): ingressi float e bf16, micro-kernel float ——
+#define GEMM_T float
+#define GEMM_KERNEL KernelF32
+
+#define GEMM_IN float
+#define GEMM_LOAD(x) (x)
+#define GEMM_NOME f32
+#include "gemm_tmpl.h"
+#undef GEMM_IN
+#undef GEMM_LOAD
+#undef GEMM_NOME
+
+#define GEMM_IN uint16_t
+#define GEMM_LOAD(x) bf16_to_float(x)
+#define GEMM_NOME bf16
+#include "gemm_tmpl.h"
+#undef GEMM_IN
+#undef GEMM_LOAD
+#undef GEMM_NOME
+
+#undef GEMM_T
+#undef GEMM_KERNEL
+
+void gemm_f32(size_t M, size_t N, size_t K, float alpha,
+              const float *A, size_t lda,
+              const float *B, size_t ldb,
+              float beta, float *C, size_t ldc) {
+    gemm_blocchi_f32(select_kernel_f32(), M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+void gemm_bf16(size_t M, size_t N, size_t K, float alpha,
+               const uint16_t *A, size_t lda,
+               const uint16_t *B, size_t ldb,
+               float beta, float *C, size_t ldc) {
+    gemm_blocchi_bf16(select_kernel_f32(), M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
@@ -0,0 +1,160 @@
+// gemm_tmpl.h
+// Schema a blocchi di gemm() indipendente dal tipo degli elementi: impacchettamento,
+// macro-kernel, tile ai bordi e divisione del lavoro tra i thread. Viene incluso una volta
+// da functions.c (double) e due da gemm_mixed.c (float e bfloat16) con definiti:
+//   GEMM_T         tipo usato dal micro-kernel e di C (double / float)
+//   GEMM_IN        tipo di A e B in memoria (double / float / uint16_t)
+//   GEMM_LOAD(x)   conversione da GEMM_IN a GEMM_T, fatta durante l'impacchettamento
+//   GEMM_NOME      suffisso delle funzioni generate (f64 / f32 / bf16)
+//   GEMM_KERNEL    struct del micro-kernel, con campi mr, nr e fn
+// e genera NOME(gemm_blocchi) = gemm_blocchi_f64 / _f32 / _bf16.
+
+#define CAT_(x, y) x##y
+#define CAT(x, y) CAT_(x, y)
+#define NOME(f) CAT(CAT(f, _), GEMM_NOME)
+#define T GEMM_T
+
+// Copia il blocco mc x kc di A in pannelli da MR righe: per ogni k gli MR valori
+// di una colonna sono contigui, cosi' il micro-kernel legge A in modo sequenziale.
+// Le righe mancanti dell'ultimo pannello vengono riempite con zeri.
+static void NOME(pack_A)(size_t mc, size_t kc, const GEMM_IN *A, size_t lda, T *Ap, size_t MR) {
+    for (size_t i = 0; i < mc; i += MR) {
+        size_t mr = mc - i < MR ? mc - i : MR;
+        for (size_t k = 0; k < kc; k++) {
+            for (size_t r = 0; r < mr; r++)
+                Ap[r] = GEMM_LOAD(A[(i + r) * lda + k]);
+            for (size_t r = mr; r < MR; r++)
+                Ap[r] = 0;
+            Ap += MR;
+        }
+    }
+}
+
+// Copia il blocco kc x nc di B in pannelli da NR colonne (righe di NR valori contigui).
+static void NOME(pack_B)(size_t kc, size_t nc, const GEMM_IN *B, size_t ldb, T *Bp, size_t NR) {
+    for (size_t j = 0; j < nc; j += NR) {
+        size_t nr = nc - j < NR ? nc - j : NR;
+        for (size_t k = 0; k < kc; k++) {
+            const GEMM_IN *b = B + k * ldb + j;
+            for (size_t c = 0; c < nr; c++)
+                Bp[c] = GEMM_LOAD(b[c]);
+            for (size_t c = nr; c < NR; c++)
+                Bp[c] = 0;
+            Bp += NR;
+        }
+    }
+}
+
+// Tile ai bordi (mr < MR o nr < NR): si calcola in un buffer MR x NR e si copia
+// solo la parte valida, cosi' il micro-kernel resta unico.
+static void NOME(edge_kernel)(const GEMM_KERNEL *kern, size_t mr, size_t nr, size_t kc,
+                              const T *Ap, const T *Bp, T *C, size_t ldc, T alpha, T beta) {
+    T tmp[MR_MAX * NR_MAX];
+    size_t NR = kern->nr;
+
+    kern->fn(kc, Ap, Bp, tmp, NR, 1, 0);
+    for (size_t r = 0; r < mr; r++) {
+        for (size_t c = 0; c < nr; c++) {
+            if (beta == 0)
+                C[r * ldc + c] = alpha * tmp[r * NR + c];
+            else
+                C[r * ldc + c] = alpha * tmp[r * NR + c] + beta * C[r * ldc + c];
+        }
+    }
+}
+
+// Macro-kernel: C[mc x nc] (op)= alpha * Ap * Bp con A e B gia' impacchettati.
+// Bp punta al primo pannello da NR colonne di questo blocco.
+static void NOME(macro_kernel)(const GEMM_KERNEL *kern, size_t mc, size_t nc, size_t kc, const T *Ap,
+                               const T *Bp, T alpha, T beta, T *C, size_t ldc) {
+    size_t MR = kern->mr, NR = kern->nr;
+
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t nr = nc - jr < NR ? nc - jr : NR;
+        const T *Bpanel = Bp + jr * kc;
+
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            size_t mr = mc - ir < MR ? mc - ir : MR;
+            const T *Apanel = Ap + ir * kc;
+            T *Ctile = C + ir * ldc + jr;
+
+            if (mr == MR && nr == NR)
+                kern->fn(kc, Apanel, Bpanel, Ctile, ldc, alpha, beta);
+            else
+                NOME(edge_kernel)(kern, mr, nr, kc, Apanel, Bpanel, Ctile, ldc, alpha, beta);
+        }
+    }
+}
+
+// C = alpha * A * B + beta * C con il micro-kernel kern e gemm_get_threads() thread
+static void NOME(gemm_blocchi)(const GEMM_KERNEL *kern, size_t M, size_t N, size_t K, T alpha,
+                               const GEMM_IN *A, size_t lda, const GEMM_IN *B, size_t ldb,
+                               T beta, T *C, size_t ldc) {
+    if (M == 0 || N == 0)
+        return;
+    if (K == 0 || alpha == 0) {
+        // non c'e' nulla da sommare: C viene solo scalata per beta
+        for (size_t i = 0; i < M; i++)
+            for (size_t j = 0; j < N; j++)
+                C[i * ldc + j] = beta == 0 ? 0 : beta * C[i * ldc + j];
+        return;
+    }
+
+    size_t NR = kern->nr;
+    int nthreads = gemm_get_threads();
+    T *Bp = gemm_buffer_B();
+
+    // Per ogni blocco di colonne jc e ogni blocco pc lungo K il pannello KC x NC di B viene
+    // impacchettato una volta sola (i thread si dividono i pannelli da NR colonne) e poi
+    // condiviso: ogni lavoro impacchetta un blocco MC x KC di A e lo moltiplica per una
+    // fetta del pannello. Le fette servono solo se i blocchi di A sono meno dei thread.
+    size_t m_blocks = (M + MC - 1) / MC;
+
+    #pragma omp parallel num_threads(nthreads) if (nthreads > 1)
+    {
+        T *Ap = gemm_buffer_A();
+
+        for (size_t jc = 0; jc < N; jc += NC) {
+            size_t nc = N - jc < NC ? N - jc : NC;
+            size_t panels = (nc + NR - 1) / NR;
+            size_t n_split = ((size_t)nthreads + m_blocks - 1) / m_blocks;
+            if (n_split > panels)
+                n_split = panels;
+            long n_jobs = (long)(m_blocks * n_split);
+
+            for (size_t pc = 0; pc < K; pc += KC) {
+                size_t kc = K - pc < KC ? K - pc : KC;
+                // beta va applicato una sola volta: al primo blocco lungo K
+                T beta_eff = pc == 0 ? beta : 1;
+
+                #pragma omp for schedule(static)
+                for (long p = 0; p < (long)panels; p++) {
+                    size_t j = (size_t)p * NR;
+                    NOME(pack_B)(kc, nc - j < NR ? nc - j : NR, B + pc * ldb + jc + j, ldb, Bp + j * kc, NR);
+                }
+                // (barriera implicita: il pannello e' pronto per tutti)
+
+                // lavori consecutivi scorrono lungo M e condividono la stessa fetta di B
+                #pragma omp for schedule(dynamic, 1)
+                for (long t = 0; t < n_jobs; t++) {
+                    size_t ic = (size_t)t % m_blocks * MC;
+                    size_t s = (size_t)t / m_blocks;
+                    size_t j0 = panels * s / n_split * NR, j1 = panels * (s + 1) / n_split * NR;
+                    size_t mc = M - ic < MC ? M - ic : MC;
+                    if (j1 > nc)
+                        j1 = nc;
+
+                    NOME(pack_A)(mc, kc, A + ic * lda + pc, lda, Ap, kern->mr);
+                    NOME(macro_kernel)(kern, mc, j1 - j0, kc, Ap, Bp + j0 * kc, alpha, beta_eff,
+                                       C + ic * ldc + jc + j0, ldc);
+                }
+                // (barriera implicita: Bp si puo' sovrascrivere)
+            }
+        }
+    }
+}
+
+#undef CAT_
+#undef CAT
+#undef NOME
+#undef T
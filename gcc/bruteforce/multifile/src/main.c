@@ -1,16 +1,313 @@
 // main.c
 #include "functions.h"
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+// Uso: ./benchmark [opzioni] [n1 n2 ...]
+//   n1 n2 ...    dimensioni delle matrici quadrate (default 1000)
+//   -r rip       ripetizioni misurate per ogni caso (default 5)
+//   -w warmup    esecuzioni di riscaldamento non misurate (default 1)
+//   -t thread    numero di thread di gemm() (default GEMM_THREADS / core disponibili)
+//   -s soglia    usa Strassen-Winograd fino alla soglia indicata, poi il gemm a blocchi
+//   -p           confronta le varianti f64 / f32 / bf16 (errore relativo rispetto a f64)
+//   -o file      salva i risultati; il formato segue l'estensione (.json, altrimenti CSV)
+//
+// Compilazione: gcc -O3 -fopenmp src/*.c -o benchmark -lm
+
+#define MAX_SIZES 64
+#define MAX_RESULTS 256
+
+typedef enum { MODE_F64, MODE_STRASSEN, MODE_F32, MODE_BF16 } Mode;
+
+static const char *mode_names[] = {"f64", "strassen", "f32", "bf16"};
+
+// Operandi di un caso di benchmark: le copie float/bf16 servono solo con -p
+typedef struct {
+    Matrix A, B, C;
+    float *Af, *Bf, *Cf;
+    uint16_t *Ah, *Bh;
+} Operands;
+
+typedef struct {
+    Mode mode;
+    size_t n;
+    int reps, warmup, threads;
+    double min, median, p95;    // secondi (tempo reale)
+    double gflops, gbs;         // calcolati sul tempo minimo
+    double error;               // errore rispetto a f64 (-1 se non calcolato)
+} Result;
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// 0 se ok, -1 se la moltiplicazione non e' stata eseguita (Strassen senza memoria)
+static int run_once(Mode mode, Operands *op) {
+    size_t n = op->A.rows;
+    switch (mode) {
+    case MODE_F64:
+        gemm(n, n, n, 1.0, op->A.data, op->A.stride, op->B.data, op->B.stride, 0.0, op->C.data, op->C.stride);
+        break;
+    case MODE_STRASSEN:
+        return multiply_matrices_strassen(&op->A, &op->B, &op->C);
+    case MODE_F32:
+        gemm_f32(n, n, n, 1.0f, op->Af, n, op->Bf, n, 0.0f, op->Cf, n);
+        break;
+    case MODE_BF16:
+        gemm_bf16(n, n, n, 1.0f, op->Ah, n, op->Bh, n, 0.0f, op->Cf, n);
+        break;
+    }
+    return 0;
+}
+
+// Esegue warmup + reps moltiplicazioni e calcola in *out min / mediana / p95 del tempo reale.
+// Restituisce -1 (senza risultato) se una delle moltiplicazioni fallisce.
+static int bench_case(Mode mode, Operands *op, int reps, int warmup, Result *out) {
+    Result r = {mode, op->A.rows, reps, warmup, gemm_get_threads(), 0, 0, 0, 0, 0, -1.0};
+    double *times = malloc(reps * sizeof(double));
+    if (!times) {
+        printf("Errore di allocazione memoria\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < warmup + reps; i++) {
+        double start = wall_time();
+        if (run_once(mode, op)) {
+            free(times);
+            return -1;
+        }
+        if (i >= warmup)
+            times[i - warmup] = wall_time() - start;
+    }
+
+    qsort(times, reps, sizeof(double), cmp_double);
+    r.min = times[0];
+    r.median = reps % 2 ? times[reps / 2] : (times[reps / 2 - 1] + times[reps / 2]) / 2;
+    r.p95 = times[(size_t)ceil(0.95 * reps) - 1];
+
+    // traffico minimo inevitabile: leggere A e B, leggere e scrivere C
+    double n = (double)r.n;
+    double elem = mode == MODE_F64 || mode == MODE_STRASSEN ? 8.0 : mode == MODE_F32 ? 4.0 : 2.0;
+    double bytes = 2 * n * n * elem + 2 * n * n * (elem == 8.0 ? 8.0 : 4.0);
+    r.gflops = 2.0 * n * n * n / r.min * 1e-9;
+    r.gbs = bytes / r.min * 1e-9;
+
+    free(times);
+    *out = r;
+    return 0;
+}
+
+// Errore relativo massimo rispetto al riferimento in double
+static double max_rel_error(const Operands *op, const Matrix *ref, Mode mode) {
+    double err = 0.0;
+    for (size_t i = 0; i < ref->rows; i++) {
+        for (size_t j = 0; j < ref->cols; j++) {
+            double r = MAT(ref, i, j);
+            double x = mode == MODE_STRASSEN ? MAT(&op->C, i, j) : (double)op->Cf[i * ref->cols + j];
+            if (r != 0.0)
+                err = fmax(err, fabs(x - r) / fabs(r));
+        }
+    }
+    return err;
+}
+
+static void operands_free(Operands *op) {
+    matrix_free(&op->A);
+    matrix_free(&op->B);
+    matrix_free(&op->C);
+    free(op->Af);
+    free(op->Bf);
+    free(op->Cf);
+    free(op->Ah);
+    free(op->Bh);
+}
+
+// Restituisce -1 (senza lasciare nulla allocato) se la memoria non basta
+static int operands_init(Operands *op, size_t n, int low_precision) {
+    memset(op, 0, sizeof(*op));
+    if (matrix_init(&op->A, n, n) || matrix_init(&op->B, n, n) || matrix_init(&op->C, n, n)) {
+        operands_free(op);
+        return -1;
+    }
+    initialize_matrices(&op->A, &op->B, &op->C);
+    if (!low_precision)
+        return 0;
+
+    // n * n non deve traboccare nemmeno moltiplicato per sizeof(float)
+    if (n > SIZE_MAX / sizeof(float) / n) {
+        operands_free(op);
+        return -1;
+    }
+    op->Af = malloc(n * n * sizeof(float));
+    op->Bf = malloc(n * n * sizeof(float));
+    op->Cf = malloc(n * n * sizeof(float));
+    op->Ah = malloc(n * n * sizeof(uint16_t));
+    op->Bh = malloc(n * n * sizeof(uint16_t));
+    if (!op->Af || !op->Bf || !op->Cf || !op->Ah || !op->Bh) {
+        operands_free(op);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            op->Af[i * n + j] = (float)MAT(&op->A, i, j);
+            op->Bf[i * n + j] = (float)MAT(&op->B, i, j);
+            op->Ah[i * n + j] = float_to_bf16(op->Af[i * n + j]);
+            op->Bh[i * n + j] = float_to_bf16(op->Bf[i * n + j]);
+        }
+    }
+    return 0;
+}
+
+static void print_result(const Result *r) {
+    printf("  %-9s min %8.4f s  mediana %8.4f s  p95 %8.4f s  %8.2f GFLOP/s  %7.2f GB/s",
+           mode_names[r->mode], r->min, r->median, r->p95, r->gflops, r->gbs);
+    if (r->error >= 0)
+        printf("  errore rel. %.3e", r->error);
+    printf("\n");
+}
+
+static void write_results(const char *path, const Result *res, int n_res) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return;
+    }
+    const char *ext = strrchr(path, '.');
+    int json = ext && strcmp(ext, ".json") == 0;
+
+    if (json) {
+        fprintf(fp, "[\n");
+        for (int i = 0; i < n_res; i++) {
+            const Result *r = &res[i];
+            fprintf(fp, "  {\"mode\": \"%s\", \"isa\": \"%s\", \"threads\": %d, \"n\": %zu, "
+                        "\"reps\": %d, \"warmup\": %d, \"min_s\": %.6f, \"median_s\": %.6f, "
+                        "\"p95_s\": %.6f, \"gflops\": %.3f, \"gbs\": %.3f",
+                    mode_names[r->mode], gemm_isa(), r->threads, r->n, r->reps, r->warmup,
+                    r->min, r->median, r->p95, r->gflops, r->gbs);
+            if (r->mode == MODE_STRASSEN)
+                fprintf(fp, ", \"strassen_cutoff\": %zu", strassen_get_cutoff());
+            if (r->error >= 0)
+                fprintf(fp, ", \"rel_error\": %.6e", r->error);
+            fprintf(fp, "}%s\n", i + 1 < n_res ? "," : "");
+        }
+        fprintf(fp, "]\n");
+    } else {
+        fprintf(fp, "mode,isa,threads,n,reps,warmup,min_s,median_s,p95_s,gflops,gbs,rel_error\n");
+        for (int i = 0; i < n_res; i++) {
+            const Result *r = &res[i];
+            fprintf(fp, "%s,%s,%d,%zu,%d,%d,%.6f,%.6f,%.6f,%.3f,%.3f,",
+                    mode_names[r->mode], gemm_isa(), r->threads, r->n, r->reps, r->warmup,
+                    r->min, r->median, r->p95, r->gflops, r->gbs);
+            if (r->error >= 0)
+                fprintf(fp, "%.6e", r->error);
+            fprintf(fp, "\n");
+        }
+    }
+    fclose(fp);
+    printf("Risultati salvati in %s\n", path);
+}
+
+int main(int argc, char *argv[]) {
+    int reps = 5, warmup = 1, use_strassen = 0, precision = 0, opt;
+    const char *out_path = NULL;
+
+    while ((opt = getopt(argc, argv, "r:w:t:s:po:")) != -1) {
+        switch (opt) {
+        case 'r': reps = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+        case 'w': warmup = atoi(optarg) >= 0 ? atoi(optarg) : 0; break;
+        case 't': gemm_set_threads(atoi(optarg)); break;
+        case 's': use_strassen = 1; strassen_set_cutoff(strtoull(optarg, NULL, 10)); break;
+        case 'p': precision = 1; break;
+        case 'o': out_path = optarg; break;
+        default:
+            printf("Uso: %s [-r rip] [-w warmup] [-t thread] [-s soglia] [-p] [-o file] [n ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    size_t sizes[MAX_SIZES];
+    int n_sizes = 0;
+    for (int i = optind; i < argc && n_sizes < MAX_SIZES; i++)
+        sizes[n_sizes++] = strtoull(argv[i], NULL, 10);
+    if (n_sizes == 0)
+        sizes[n_sizes++] = 1000;
 
-int main() {
     srand(time(NULL));
-    
-    initialize_matrices();
-    
-    clock_t start = clock();
-    multiply_matrices();
-    clock_t end = clock();
-    
-    print_execution_time(start, end);
-    
+    printf("Micro-kernel: %s, thread: %d, ripetizioni: %d, warmup: %d\n",
+           gemm_isa(), gemm_get_threads(), reps, warmup);
+
+    Result results[MAX_RESULTS];
+    int n_res = 0;
+
+    for (int s = 0; s < n_sizes; s++) {
+        size_t n = sizes[s];
+        if (n == 0)
+            continue;
+
+        Operands op;
+        if (operands_init(&op, n, precision)) {
+            printf("Errore di allocazione memoria per n = %zu, dimensione saltata\n", n);
+            continue;
+        }
+        printf("n = %zu (huge pages: %s)\n", n, op.A.huge ? "si" : "no");
+
+        // il riferimento f64 si misura sempre; l'ultima esecuzione resta in C
+        Result ref;
+        bench_case(MODE_F64, &op, reps, warmup, &ref); // gemm non fallisce
+        print_result(&ref);
+        if (n_res < MAX_RESULTS)
+            results[n_res++] = ref;
+
+        Matrix C_ref = {0};
+        if (use_strassen || precision) {
+            if (matrix_init(&C_ref, n, n)) {
+                printf("Errore di allocazione memoria per n = %zu, dimensione saltata\n", n);
+                operands_free(&op);
+                continue;
+            }
+            for (size_t i = 0; i < n; i++)
+                memcpy(&MAT(&C_ref, i, 0), &MAT(&op.C, i, 0), n * sizeof(double));
+        }
+
+        if (use_strassen) {
+            Result r;
+            double bound = 0.0, err;
+            if (bench_case(MODE_STRASSEN, &op, reps, warmup, &r)) {
+                printf("  strassen: moltiplicazione non eseguita, caso saltato\n");
+            } else {
+                r.error = max_rel_error(&op, &C_ref, MODE_STRASSEN);
+                print_result(&r);
+                if ((err = strassen_check(&op.A, &op.B, &op.C, &bound)) < 0)
+                    printf("  Strassen-Winograd: verifica non eseguita (memoria insufficiente)\n");
+                else
+                    printf("  Strassen-Winograd (soglia %zu): errore massimo %.3e, limite teorico %.3e -> %s\n",
+                           strassen_get_cutoff(), err, bound, err <= bound ? "OK" : "FUORI LIMITE");
+                if (n_res < MAX_RESULTS)
+                    results[n_res++] = r;
+            }
+        }
+
+        if (precision) {
+            for (Mode m = MODE_F32; m <= MODE_BF16; m++) {
+                Result r;
+                bench_case(m, &op, reps, warmup, &r);
+                r.error = max_rel_error(&op, &C_ref, m);
+                print_result(&r);
+                if (n_res < MAX_RESULTS)
+                    results[n_res++] = r;
+            }
+        }
+
+        if (C_ref.data)
+            matrix_free(&C_ref);
+        operands_free(&op);
+    }
+
+    if (out_path)
+        write_results(out_path, results, n_res);
+
+    gemm_release_buffers();
     return 0;
 }
@@ -0,0 +1,185 @@
+// strassen.c
+#include "functions.h"
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+// Strassen-Winograd: 7 prodotti e 15 somme per livello invece di 8 prodotti.
+// Sotto la soglia (cutoff) si torna al gemm a blocchi, che su matrici piccole e' piu' veloce.
+//
+// Lo schedule e' quello di Douglas, Heroux, Slishman e Smith (1994): i quadranti di C
+// fanno da temporanei e servono solo due buffer per livello, X (m2 x max(k2, n2)) e
+// Y (k2 x n2), presi da un'unica arena allocata prima di iniziare. Ogni livello prende
+// i suoi X e Y in testa all'arena e passa il resto ai figli, che girano uno dopo l'altro:
+// nessuna malloc durante la ricorsione.
+
+#define STRASSEN_DEFAULT_CUTOFF 1024
+
+static size_t strassen_cutoff = 0; // 0 = non ancora impostato
+
+void strassen_set_cutoff(size_t cutoff) {
+    strassen_cutoff = cutoff > 0 ? cutoff : 1;
+}
+
+size_t strassen_get_cutoff(void) {
+    if (strassen_cutoff == 0) {
+        const char *env = getenv("STRASSEN_CUTOFF");
+        strassen_cutoff = env && atol(env) > 0 ? (size_t)atol(env) : STRASSEN_DEFAULT_CUTOFF;
+    }
+    return strassen_cutoff;
+}
+
+// arrotonda a 8 double, cosi' ogni buffer dell'arena resta allineato a 64 byte
+static size_t round8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+static size_t max_sz(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+// Elementi di arena necessari per moltiplicare (M x K) * (K x N) con la soglia data
+static size_t workspace_size(size_t M, size_t N, size_t K, size_t cutoff) {
+    if (M <= cutoff || N <= cutoff || K <= cutoff)
+        return 0;
+    size_t m2 = M / 2, n2 = N / 2, k2 = K / 2;
+    return round8(m2 * max_sz(k2, n2)) + round8(k2 * n2) + workspace_size(m2, n2, k2, cutoff);
+}
+
+// C = A + sign * B   (blocchi m x n)
+static void mat_add(size_t m, size_t n, const double *A, size_t lda, const double *B, size_t ldb,
+                    double sign, double *C, size_t ldc) {
+    #pragma omp parallel for if (m * n > 65536)
+    for (size_t i = 0; i < m; i++) {
+        const double *a = A + i * lda, *b = B + i * ldb;
+        double *c = C + i * ldc;
+        for (size_t j = 0; j < n; j++)
+            c[j] = a[j] + sign * b[j];
+    }
+}
+
+// C = A * B con A M x K, B K x N. ws punta all'arena libera per questo livello.
+static void strassen_rec(size_t M, size_t N, size_t K,
+                         const double *A, size_t lda, const double *B, size_t ldb,
+                         double *C, size_t ldc, double *ws, size_t cutoff) {
+    if (M <= cutoff || N <= cutoff || K <= cutoff) {
+        gemm(M, N, K, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+        return;
+    }
+
+    // parte pari: la ricorsione lavora sui primi m x k e k x n elementi,
+    // l'eventuale riga/colonna dispari viene sistemata alla fine con gemm
+    size_t m2 = M / 2, n2 = N / 2, k2 = K / 2;
+    size_t m = 2 * m2, n = 2 * n2, k = 2 * k2;
+
+    const double *A11 = A, *A12 = A + k2, *A21 = A + m2 * lda, *A22 = A21 + k2;
+    const double *B11 = B, *B12 = B + n2, *B21 = B + k2 * ldb, *B22 = B21 + n2;
+    double *C11 = C, *C12 = C + n2, *C21 = C + m2 * ldc, *C22 = C21 + n2;
+
+    size_t ldx = max_sz(k2, n2), ldy = n2;
+    double *X = ws;
+    double *Y = X + round8(m2 * ldx);
+    double *rest = Y + round8(k2 * ldy);
+
+    mat_add(m2, k2, A11, lda, A21, lda, -1.0, X, ldx);                     // S3 = A11 - A21
+    mat_add(k2, n2, B22, ldb, B12, ldb, -1.0, Y, ldy);                     // T3 = B22 - B12
+    strassen_rec(m2, n2, k2, X, ldx, Y, ldy, C21, ldc, rest, cutoff);      // P7 = S3 * T3
+    mat_add(m2, k2, A21, lda, A22, lda, 1.0, X, ldx);                      // S1 = A21 + A22
+    mat_add(k2, n2, B12, ldb, B11, ldb, -1.0, Y, ldy);                     // T1 = B12 - B11
+    strassen_rec(m2, n2, k2, X, ldx, Y, ldy, C22, ldc, rest, cutoff);      // P5 = S1 * T1
+    mat_add(m2, k2, X, ldx, A11, lda, -1.0, X, ldx);                       // S2 = S1 - A11
+    mat_add(k2, n2, B22, ldb, Y, ldy, -1.0, Y, ldy);                       // T2 = B22 - T1
+    strassen_rec(m2, n2, k2, X, ldx, Y, ldy, C12, ldc, rest, cutoff);      // P6 = S2 * T2
+    mat_add(m2, k2, A12, lda, X, ldx, -1.0, X, ldx);                       // S4 = A12 - S2
+    strassen_rec(m2, n2, k2, X, ldx, B22, ldb, C11, ldc, rest, cutoff);    // P3 = S4 * B22
+    strassen_rec(m2, n2, k2, A11, lda, B11, ldb, X, ldx, rest, cutoff);    // P1 = A11 * B11
+    mat_add(m2, n2, X, ldx, C12, ldc, 1.0, C12, ldc);                      // U2 = P1 + P6
+    mat_add(m2, n2, C12, ldc, C21, ldc, 1.0, C21, ldc);                    // U3 = U2 + P7
+    mat_add(m2, n2, C12, ldc, C22, ldc, 1.0, C12, ldc);                    // U4 = U2 + P5
+    mat_add(m2, n2, C21, ldc, C22, ldc, 1.0, C22, ldc);                    // C22 = U3 + P5
+    mat_add(m2, n2, C12, ldc, C11, ldc, 1.0, C12, ldc);                    // C12 = U4 + P3
+    mat_add(k2, n2, Y, ldy, B21, ldb, -1.0, Y, ldy);                       // T4 = T2 - B21
+    strassen_rec(m2, n2, k2, A22, lda, Y, ldy, C11, ldc, rest, cutoff);    // P4 = A22 * T4
+    mat_add(m2, n2, C21, ldc, C11, ldc, -1.0, C21, ldc);                   // C21 = U3 - P4
+    strassen_rec(m2, n2, k2, A12, lda, B21, ldb, C11, ldc, rest, cutoff);  // P2 = A12 * B21
+    mat_add(m2, n2, X, ldx, C11, ldc, 1.0, C11, ldc);                      // C11 = P1 + P2
+
+    // bordi dispari
+    if (K > k)  // contributo dell'ultima colonna di A / ultima riga di B
+        gemm(m, n, 1, 1.0, A + k, lda, B + k * ldb, ldb, 1.0, C, ldc);
+    if (N > n)  // ultima colonna di C
+        gemm(M, 1, K, 1.0, A, lda, B + n, ldb, 0.0, C + n, ldc);
+    if (M > m)  // ultima riga di C
+        gemm(1, n, K, 1.0, A + m * lda, lda, B, ldb, 0.0, C + m * ldc, ldc);
+}
+
+int multiply_matrices_strassen(const Matrix *A, const Matrix *B, Matrix *C) {
+    if (A->cols != B->rows || C->rows != A->rows || C->cols != B->cols) {
+        printf("Dimensioni incompatibili: (%zux%zu) * (%zux%zu) -> (%zux%zu)\n",
+               A->rows, A->cols, B->rows, B->cols, C->rows, C->cols);
+        return -1;
+    }
+
+    size_t cutoff = strassen_get_cutoff();
+    size_t ws_elems = workspace_size(A->rows, B->cols, A->cols, cutoff);
+    double *ws = NULL;
+    if (ws_elems > 0) {
+        ws = aligned_alloc(64, ws_elems * sizeof(double));
+        if (!ws) {
+            printf("Errore di allocazione memoria\n");
+            return -1;
+        }
+    }
+
+    strassen_rec(A->rows, B->cols, A->cols, A->data, A->stride, B->data, B->stride,
+                 C->data, C->stride, ws, cutoff);
+
+    free(ws);
+    return 0;
+}
+
+static double max_abs(const Matrix *m) {
+    double r = 0.0;
+    for (size_t i = 0; i < m->rows; i++)
+        for (size_t j = 0; j < m->cols; j++)
+            r = fmax(r, fabs(MAT(m, i, j)));
+    return r;
+}
+
+// Livelli di ricorsione effettivamente eseguiti per una matrice n x n
+static int strassen_levels(size_t n, size_t cutoff) {
+    int levels = 0;
+    while (n > cutoff) {
+        n /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+double strassen_check(const Matrix *A, const Matrix *B, const Matrix *C, double *bound) {
+    size_t M = A->rows, N = B->cols, K = A->cols;
+    Matrix ref;
+    if (matrix_init(&ref, M, N))
+        return -1.0;
+    gemm(M, N, K, 1.0, A->data, A->stride, B->data, B->stride, 0.0, ref.data, ref.stride);
+
+    double err = 0.0;
+    for (size_t i = 0; i < M; i++)
+        for (size_t j = 0; j < N; j++)
+            err = fmax(err, fabs(MAT(C, i, j) - MAT(&ref, i, j)));
+    matrix_free(&ref);
+
+    // Limite in norma del massimo per Winograd con L livelli e foglie da n0 (Higham,
+    // "Accuracy and Stability of Numerical Algorithms", cap. 23):
+    //   |C - C^| <= [ (n0^2 + 6 n0) * 18^L - 6 n ] u |A| |B|
+    // con n0 = n / 2^L. La somma classica ha invece n u |A| |B|.
+    size_t n = K;
+    int L = strassen_levels(n, strassen_get_cutoff());
+    double n0 = (double)n / ldexp(1.0, L);
+    double u = DBL_EPSILON / 2;
+    double factor = (n0 * n0 + 6 * n0) * pow(18.0, L) - 6.0 * (double)n;
+    if (factor < (double)n)
+        factor = (double)n;
+    *bound = factor * u * max_abs(A) * max_abs(B);
+    return err;
+}
@@ -0,0 +1,116 @@
+// Compilazione: gcc -O2 [-fopenmp] bench.c vectLib.c -o bench -lm
+#include <stdio.h> // printf
+#include <stdlib.h> // malloc, strtoull
+#include <stdint.h> // uint64_t
+#include <time.h> // clock_gettime
+#include <math.h> // exp
+#include "vectLib.h" // operazioni sui vettori
+
+#define RIPETIZIONI 5
+
+double tempo_reale(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Miglior tempo su RIPETIZIONI esecuzioni e banda ottenuta (byte letti + scritti)
+void stampa(const char *nome, double t, size_t byte) {
+    printf("  %-10s %9.3f ms  %6.1f GB/s\n", nome, t * 1e3, byte / t * 1e-9);
+}
+
+#define MISURA(nome, byte, istruzione)                   \
+    do {                                                 \
+        double migliore = 1e30;                          \
+        for (int r_ = 0; r_ < RIPETIZIONI; r_++) {       \
+            double t0_ = tempo_reale();                  \
+            istruzione;                                  \
+            double t_ = tempo_reale() - t0_;             \
+            if (t_ < migliore)                           \
+                migliore = t_;                           \
+        }                                                \
+        stampa(nome, migliore, byte);                    \
+    } while (0)
+
+// Uso: ./bench [dim]  -> misura le operazioni di vectLib su vettori di dim double
+// (default 10^7; per shift e rotazioni ./bench 100000000). VECT_ISA=avx512|avx2|generic forza i kernel,
+// VECT_THREADS il numero di thread (con -fopenmp).
+int main(int argc, char *argv[]) {
+    size_t dim = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    double *a = malloc(dim * sizeof(double));
+    double *b = malloc(dim * sizeof(double));
+    double *res = malloc(dim * sizeof(double));
+    if (!a || !b || !res) {
+        printf("Errore di allocazione della memoria.\n");
+        return 1;
+    }
+    for (size_t i = 0; i < dim; i++) {
+        a[i] = (double)(i % 1000) * 0.5;
+        b[i] = 1.0 - (double)(i % 777);
+    }
+    fill_vec(res, dim, 0.0); // le pagine di res vengono toccate prima delle misure
+
+    printf("%zu elementi, kernel %s, %d thread\n", dim, vect_isa(), vect_get_threads());
+    size_t v = dim * sizeof(double);
+    volatile double scarto; // impedisce al compilatore di eliminare le riduzioni
+
+    MISURA("add", 3 * v, add_vec(a, b, res, dim));
+    MISURA("sub", 3 * v, sub_vec(a, b, res, dim));
+    MISURA("adds", 2 * v, adds_vec(a, 1.5, res, dim));
+    MISURA("muls", 2 * v, muls_vec(a, 1.5, res, dim));
+    MISURA("dot", 2 * v, scarto = dot_vec(a, b, dim));
+    MISURA("norm", v, scarto = norm_vec(a, dim));
+    MISURA("sum", v, scarto = sum_vec(a, dim));
+    MISURA("mean", v, scarto = mean_vec(a, dim));
+    MISURA("min", v, scarto = min_vec(a, dim));
+    MISURA("max", v, scarto = max_vec(a, dim));
+
+    // sum((a + b) * k): tre passate con un temporaneo contro una passata fusa
+    MISURA("3 passate", 5 * v, (add_vec(a, b, res, dim), muls_vec(res, 1.5, res, dim),
+                                scarto = sum_vec(res, dim)));
+    vec_expr e;
+    vec_expr_init(&e, a, dim);
+    vec_expr_muls(vec_expr_add(&e, b), 1.5);
+    MISURA("fusa", 2 * v, scarto = vec_expr_sum(&e));
+    MISURA("fusa eval", 3 * v, vec_expr_eval(&e, res));
+
+    // exp: funzione scalare chiamata per elemento contro kernel a blocchi
+    vec_expr m;
+    vec_expr_init(&m, a, dim);
+    vec_expr_map(&m, exp);
+    MISURA("exp map", 2 * v, vec_expr_eval(&m, res));
+    MISURA("exp_vec", 2 * v, exp_vec(a, res, dim));
+    MISURA("log_vec", 2 * v, log_vec(a, res, dim));
+    MISURA("sigmoid", 2 * v, sigmoid_vec(a, res, dim));
+    (void)scarto;
+
+    // shift e rotazioni: passo corto (buffer + memmove) e passo lungo (tre inversioni)
+    size_t passi[] = {1, 1000, dim / 3};
+    for (int p = 0; p < 3; p++) {
+        printf("  passo %zu:\n", passi[p]);
+        MISURA("rshft", 2 * v, rshft_vec(res, passi[p], dim));
+        MISURA("lshft", 2 * v, lshft_vec(res, passi[p], dim));
+        MISURA("rrot", 2 * v, rrot_vec(res, passi[p], dim));
+        MISURA("lrot", 2 * v, lrot_vec(res, passi[p], dim));
+    }
+
+    // ordinamento: una sola misura, su valori pseudo-casuali (LCG) in [-1, 1)
+    uint64_t x = 12345;
+    for (size_t i = 0; i < dim; i++) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        res[i] = (double)(x >> 11) * 0x1p-52 - 1.0;
+    }
+    double t0 = tempo_reale();
+    sort_vec(res, dim);
+    double t = tempo_reale() - t0;
+    size_t fuori_posto = 0;
+    for (size_t i = 1; i < dim; i++)
+        fuori_posto += res[i] < res[i - 1];
+    printf("  %-10s %9.3f ms  %6.1f M elementi/s %s\n", "sort", t * 1e3, dim / t * 1e-6,
+           fuori_posto ? "ERRORE" : "(ordinato)");
+
+    free(a);
+    free(b);
+    free(res);
+    return 0;
+}
@@ -32,7 +32,7 @@ int main() {
     print_vec(res_muls, 5);
 
     // ------ Test di sub_vec(): sottrazione elemento per elemento ------
-    // (Attenzione: l'implementazione data potrebbe contenere errori, qui ci aspettiamo v1 - v2 = -1 in ogni elemento)
+    // ci aspettiamo v1 - v2 = -1 in ogni elemento
     double res_sub[5];
     sub_vec(v1, v2, res_sub, 5);
     printf("v1 - v2: ");
@@ -104,7 +104,7 @@ int main() {
     double v_lrot[5] = {1, 2, 3, 4, 5};
     printf("v_lrot prima di left rotation: ");
     print_vec(v_lrot, 5);
-    lrot_vec(v_lrot, 2, 5);  // ruota a sinistra di 2 posizioni (nota: l'implementazione potrebbe avere errori)
+    lrot_vec(v_lrot, 2, 5);  // ruota a sinistra di 2 posizioni, gli elementi usciti rientrano in coda
     printf("v_lrot dopo left rotation di 2: ");
     print_vec(v_lrot, 5);
 
@@ -147,5 +147,24 @@ int main() {
     printf("v_map dopo map_vec (sqrt): ");
     print_vec(v_map, 5);
 
+    // ------ Test di vec_expr: sum((v1 + v2) * 4) in una sola passata ------
+    vec_expr e;
+    vec_expr_init(&e, v1, 5);
+    vec_expr_muls(vec_expr_add(&e, v2), 4.0);
+    printf("sum((v1 + v2) * 4): %lf\n", vec_expr_sum(&e)); // (1 + 2) * 4 * 5 = 60
+    double res_expr[5];
+    vec_expr_eval(&e, res_expr);
+    printf("(v1 + v2) * 4: ");
+    print_vec(res_expr, 5);
+
+    // ------ Test delle funzioni a blocchi: exp_vec, log_vec e clamp_vec ------
+    exp_vec(v_map, res_expr, 5);
+    log_vec(res_expr, res_expr, 5); // log(exp(x)) torna a v_map
+    printf("log(exp(v_map)): ");
+    print_vec(res_expr, 5);
+    clamp_vec(v_map, 1.5, 2.5, res_expr, 5);
+    printf("v_map limitato a [1.5, 2.5]: ");
+    print_vec(res_expr, 5);
+
     return 0;
 }
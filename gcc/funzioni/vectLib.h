@@ -1,89 +1,190 @@
-#ifndef VECTLIB_H
-#define VECTLIB_H
-
-#include <stdio.h>
-#include <stdbool.h>
-
-// —— Input/Output ——
-/** Stampa il vettore v ben formattato [v1, v2, ..., vn] */
-void print_vec(const double *v, size_t dim);
-
-/** Legge dim valori da stdin e li salva nel vettore v */
-void scanf_vec(double *v, size_t dim);
-
-// —— Operazioni algebriche ——
-/** res = v1 + v2 elemento per elemento*/
-void add_vec(const double *v1, const double *v2, double *res, size_t dim);
-
-/** res = v1 + k  per ogni elemento*/
-void adds_vec(const double *v1, double k, double *res, size_t dim);
-
-/** res = v * k (moltiplicazione per scalare) */
-void muls_vec(const double *v, double k, double *res, size_t dim);
-
-/** res = v1 - v2 ...sfruttare muls_vec() */
-void sub_vec(const double *v1, const double *v2, double *res, size_t dim);
-
-/** Prodotto scalare (v1 • v2) */
-double dot_vec(const double *v1, const double *v2, size_t dim);
-
-// —— Manipolazione vettori ——
-/** Concatena v1 (dim1) e v2 (dim2) in res (dim1 + dim2 elementi) */
-void concat_vec(const double *v1, size_t dim1, const double *v2, size_t dim2, double *res);
-
-/** Inverte l'ordine degli elementi (es. [1,2,3] → [3,2,1]) */
-void reverse_vec(double *v, size_t dim);
-
-/** Ordina gli elementi in ordine crescente */
-void sort_vec(double *v, size_t dim);
-
-/** Mescola gli elementi in modo casuale */
-void shuffle_vec(double *v, size_t dim);
-
-/** Shift a destra*/
-void rshft_vec(double *v, size_t step, size_t dim);
-/** Shift a sinistra*/
-void lshft_vec(double *v, size_t step, size_t dim);
-
-/** Rotate a destra: rispetto allo shift gli elementi che escono a destra rientrano in testa (sinistra)*/
-void rrot_vec(double *v, size_t step, size_t dim);
-/** Rotate a sinistra: rispetto allo shift gli elementi che escono a sinistra rientrano in coda (destra)*/
-void lrot_vec(double *v, size_t step, size_t dim);
-
-/** Copia n elementi da src a dest (n <= dim) */
-void slice_vec(const double *src, double *dest, int start, int n);
-
-// —— Inizializzazione ——
-/** Riempie il vettore con valori casuali in [min, max] */
-void rand_vec(int *v, size_t dim, int min, int max);
-
-/** Riempie il vettore con val */
-void fill_vec(double *v, size_t dim, double val);
-
-/** Azzera il vettore */
-void zero_vec(double *v, size_t dim);
-
-// —— Norme e geometria ——
-/** Restituisce ||v|| il modulo (norma euclidea) */
-double norm_vec(const double *v, size_t dim);
-
-// —— Statistiche e utilità ——
-/** Restituisce la media degli elementi */
-double mean_vec(const double *v, size_t dim);
-
-/** Restituisce il valore minimo */
-double min_vec(const double *v, size_t dim);
-
-/** Restituisce il valore massimo */
-double max_vec(const double *v, size_t dim);
-
-/** Somma di tutti gli elementi */
-double sum_vec(const double *v, size_t dim);
-
-/** Confronta due vettori con tolleranza tol. Restituisce true se |v1_i - v2_i| < tol per tutti gli elementi */
-bool eq_vec(const double *v1, const double *v2, size_t dim, double tol);
-
-/** Applica func a ogni elemento (modifica v direttamente) */
-void map_vec(double *v, size_t dim, double (*func)(double));
-
+#ifndef VECTLIB_H
+#define VECTLIB_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// —— Input/Output ——
+/** Stampa il vettore v ben formattato [v1, v2, ..., vn] */
+void print_vec(const double *v, size_t dim);
+
+/** Legge dim valori da stdin e li salva nel vettore v */
+void scanf_vec(double *v, size_t dim);
+
+// —— Operazioni algebriche ——
+// add/adds/muls/sub/mul, dot, norm, sum, mean, min e max usano kernel AVX-512 o AVX2 + FMA
+// scelti a runtime (variabile d'ambiente VECT_ISA = avx512 | avx2 | generic per forzarli).
+// Le riduzioni usano piu' accumulatori: la somma avviene in un altro ordine e il risultato
+// puo' differire da quello del ciclo scalare per arrotondamento (ordine di dim * eps * sum |v_i|).
+// res puo' coincidere con v1 / v2 ma non sovrapporsi solo in parte.
+
+/** Nome dei kernel in uso: "avx512", "avx2" o "generic" */
+const char *vect_isa(void);
+
+// Con -fopenmp le stesse operazioni, map_vec compresa, si dividono tra i thread sopra i
+// 2 * 2^20 elementi. Sopra quella soglia sum/dot/norm/mean sommano a coppie somme parziali
+// di blocchi da 2^14 elementi: il risultato non dipende dal numero di thread e differisce
+// da quello seriale al piu' di circa (2^14 + log2(dim)) * eps * sum |v_i| (al piu'
+// dim * eps * sum |v_i| per il ciclo seriale). min e max danno lo stesso risultato del
+// ciclo seriale. map_vec richiede func thread-safe.
+
+/** Numero di thread (default: variabile d'ambiente VECT_THREADS o omp_get_max_threads()) */
+void vect_set_threads(int n);
+int vect_get_threads(void);
+
+/** res = v1 + v2 elemento per elemento*/
+void add_vec(const double *v1, const double *v2, double *res, size_t dim);
+
+/** res = v1 + k  per ogni elemento*/
+void adds_vec(const double *v1, double k, double *res, size_t dim);
+
+/** res = v * k (moltiplicazione per scalare) */
+void muls_vec(const double *v, double k, double *res, size_t dim);
+
+/** res = v1 - v2 elemento per elemento */
+void sub_vec(const double *v1, const double *v2, double *res, size_t dim);
+
+/** res = v1 * v2 elemento per elemento */
+void mul_vec(const double *v1, const double *v2, double *res, size_t dim);
+
+/** Prodotto scalare (v1 • v2) */
+double dot_vec(const double *v1, const double *v2, size_t dim);
+
+// —— Manipolazione vettori ——
+/** Concatena v1 (dim1) e v2 (dim2) in res (dim1 + dim2 elementi) */
+void concat_vec(const double *v1, size_t dim1, const double *v2, size_t dim2, double *res);
+
+/** Inverte l'ordine degli elementi (es. [1,2,3] → [3,2,1]) */
+void reverse_vec(double *v, size_t dim);
+
+/** Ordina gli elementi in ordine crescente: introsort per vettori piccoli, radix sort sui bit
+    dei double per quelli grandi (buffer temporaneo di dim elementi), con -fopenmp in parallelo
+    sopra qualche milione di elementi. Gli eventuali NaN finiscono in fondo. */
+void sort_vec(double *v, size_t dim);
+
+/** Mescola gli elementi in modo casuale */
+void shuffle_vec(double *v, size_t dim);
+
+/** Shift a destra*/
+void rshft_vec(double *v, size_t step, size_t dim);
+/** Shift a sinistra*/
+void lshft_vec(double *v, size_t step, size_t dim);
+
+/** Rotate a destra: rispetto allo shift gli elementi che escono a destra rientrano in testa (sinistra)*/
+void rrot_vec(double *v, size_t step, size_t dim);
+/** Rotate a sinistra: rispetto allo shift gli elementi che escono a sinistra rientrano in coda (destra)*/
+void lrot_vec(double *v, size_t step, size_t dim);
+
+/** Copia n elementi da src a dest (n <= dim) */
+void slice_vec(const double *src, double *dest, int start, int n);
+
+// —— Inizializzazione ——
+/** Riempie il vettore con valori casuali in [min, max] */
+void rand_vec(int *v, size_t dim, int min, int max);
+
+/** Riempie il vettore con val */
+void fill_vec(double *v, size_t dim, double val);
+
+/** Azzera il vettore */
+void zero_vec(double *v, size_t dim);
+
+// —— Norme e geometria ——
+/** Restituisce ||v|| il modulo (norma euclidea) */
+double norm_vec(const double *v, size_t dim);
+
+// —— Statistiche e utilità ——
+/** Restituisce la media degli elementi */
+double mean_vec(const double *v, size_t dim);
+
+/** Restituisce il valore minimo */
+double min_vec(const double *v, size_t dim);
+
+/** Restituisce il valore massimo */
+double max_vec(const double *v, size_t dim);
+
+/** Somma di tutti gli elementi */
+double sum_vec(const double *v, size_t dim);
+
+/** Confronta due vettori con tolleranza tol. Restituisce true se |v1_i - v2_i| < tol per tutti gli elementi */
+bool eq_vec(const double *v1, const double *v2, size_t dim, double tol);
+
+/** Applica func a ogni elemento (modifica v direttamente). Con func = sqrt o fabs usa
+    sqrt_vec / abs_vec (stesso risultato, vettorizzato). */
+void map_vec(double *v, size_t dim, double (*func)(double));
+
+// —— Funzioni a blocchi ——
+// Una funzione a blocchi calcola out[i] = f(in[i]) per n elementi con una sola chiamata:
+// niente chiamata indiretta per elemento, e dentro si possono usare istruzioni SIMD.
+// in e out possono coincidere.
+typedef void (*map_batch_fn)(const double *in, double *out, size_t n);
+
+/** Come map_vec, ma chiama f su interi blocchi (una parte per thread sopra soglia) */
+void map_batch_vec(double *v, size_t dim, map_batch_fn f);
+
+// Funzioni a blocchi gia' pronte, con kernel AVX-512 / AVX2 come add_vec: usabili con
+// map_batch_vec o direttamente (res puo' coincidere con v). exp e log hanno errore
+// sotto 1 ulp (come libm, ma non sempre lo stesso arrotondamento); sqrt, abs e clamp sono esatte.
+void exp_vec(const double *v, double *res, size_t dim);
+void log_vec(const double *v, double *res, size_t dim);
+void sqrt_vec(const double *v, double *res, size_t dim);
+void abs_vec(const double *v, double *res, size_t dim);
+/** res = 1 / (1 + e^-v) */
+void sigmoid_vec(const double *v, double *res, size_t dim);
+/** res = v limitato a [lo, hi] (i NaN restano NaN) */
+void clamp_vec(const double *v, double lo, double hi, double *res, size_t dim);
+
+// —— Espressioni fuse ——
+// Catena di operazioni elemento per elemento su un vettore sorgente, valutata a blocchi di
+// VEC_EXPR_BLOCCO elementi: ogni blocco passa per tutte le operazioni (con i kernel di
+// add_vec, muls_vec, ...) restando in cache L1, e va nel risultato o nella riduzione finale.
+// Esempio, sum((a + b) * k) con una sola lettura di a e b e nessun vettore temporaneo:
+//     vec_expr e;
+//     vec_expr_init(&e, a, dim);
+//     vec_expr_muls(vec_expr_add(&e, b), k);
+//     double s = vec_expr_sum(&e);
+// I vettori operando devono avere almeno dim elementi e restare validi fino alla valutazione.
+#define VEC_EXPR_MAX 16
+#define VEC_EXPR_BLOCCO 1024
+
+typedef struct {
+    int op;
+    const double *v;            // secondo operando (add, sub, mul)
+    double k;                   // scalare (adds, muls)
+    double (*func)(double);     // map
+    map_batch_fn batch;         // map_batch
+} vec_op;
+
+typedef struct {
+    const double *src;
+    size_t dim;
+    int n;                      // operazioni in ops
+    vec_op ops[VEC_EXPR_MAX];
+} vec_expr;
+
+/** Espressione senza operazioni sul vettore v di dim elementi */
+void vec_expr_init(vec_expr *e, const double *v, size_t dim);
+
+/** Aggiungono un'operazione in coda (x = x + v, x - v, x * v, x + k, x * k, func(x), f(x)) e
+    restituiscono e, cosi' le chiamate si possono annidare. Oltre VEC_EXPR_MAX operazioni
+    il programma termina con un errore. */
+vec_expr *vec_expr_add(vec_expr *e, const double *v);
+vec_expr *vec_expr_sub(vec_expr *e, const double *v);
+vec_expr *vec_expr_mul(vec_expr *e, const double *v);
+vec_expr *vec_expr_adds(vec_expr *e, double k);
+vec_expr *vec_expr_muls(vec_expr *e, double k);
+vec_expr *vec_expr_map(vec_expr *e, double (*func)(double));
+vec_expr *vec_expr_map_batch(vec_expr *e, map_batch_fn f);
+
+/** Scrive il risultato in res (dim elementi). res puo' coincidere con la sorgente o con un
+    operando, ma non sovrapporsi a uno di essi solo in parte. */
+void vec_expr_eval(const vec_expr *e, double *res);
+
+/** Riduzioni del risultato senza scriverlo in memoria, come sum_vec, dot_vec (con w),
+    norm_vec, min_vec e max_vec applicate al vettore risultato */
+double vec_expr_sum(const vec_expr *e);
+double vec_expr_dot(const vec_expr *e, const double *w);
+double vec_expr_norm(const vec_expr *e);
+double vec_expr_min(const vec_expr *e);
+double vec_expr_max(const vec_expr *e);
+
 #endif /* VECTLIB_H */
\ No newline at end of file
@@ -0,0 +1,76 @@
+// Compilazione: gcc -O2 -fopenmp bench_terne.c terneLib.c -o bench_terne
+#include <stdio.h> // printf, scanf
+#include <time.h> // clock_gettime
+#include "terneLib.h" // albero di Berggren, conteggio, scelta della larghezza
+
+double tempo_reale(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Scarta le terne: misura solo la generazione
+void ignoraTerne(const void *terne, size_t count, int bits, void *ctx) {
+    (void)terne;
+    (void)count;
+    (void)bits;
+    (void)ctx;
+}
+
+void stampa(const char *nome, int bits, unsigned long long terne, double t) {
+    printf("  %-12s %2d bit: %llu terne in %f secondi (%.1f M terne/s)\n",
+           nome, bits, terne, t, t > 0 ? terne / t * 1e-6 : 0.0);
+}
+
+// Uso: ./bench_terne  -> chiede N e confronta le versioni a 32 e a 64 bit
+// (generazione in memoria, generazione senza salvare, solo conteggio)
+int main(void) {
+    unsigned long long N;
+    printf("Inserisci il valore massimo N: ");
+    if (scanf("%llu", &N) != 1) {
+        printf("Input non valido.\n");
+        return 1;
+    }
+    if (terne_get_bits(N) == 0) {
+        printf("N troppo grande: il massimo e' %llu.\n", (unsigned long long)TERNE64_MAX_N);
+        return 1;
+    }
+
+    unsigned long long risultati[2][3];
+    int larghezze[2] = {32, 64};
+    for (int i = 0; i < 2; i++) {
+        terne_set_bits(larghezze[i]);
+        int bits = terne_get_bits(N);
+        if (bits != larghezze[i]) {
+            printf("%d bit: N supera %llu, salto.\n", larghezze[i], (unsigned long long)TERNE32_MAX_N);
+            risultati[i][0] = risultati[i][1] = risultati[i][2] = 0;
+            continue;
+        }
+        printf("Interi a %d bit:\n", bits);
+
+        TerneArena terne;
+        double start = tempo_reale();
+        risultati[i][0] = terne_berggren(N, &terne);
+        stampa("arena", bits, risultati[i][0], tempo_reale() - start);
+        terne_arena_free(&terne);
+
+        start = tempo_reale();
+        risultati[i][1] = terne_berggren_sink(N, ignoraTerne, NULL);
+        stampa("sink", bits, risultati[i][1], tempo_reale() - start);
+
+        start = tempo_reale();
+        risultati[i][2] = terne_conta(N);
+        stampa("conta", bits, risultati[i][2], tempo_reale() - start);
+    }
+    terne_set_bits(0);
+
+    // tutte le misure devono dare lo stesso numero di terne
+    unsigned long long atteso = risultati[1][2];
+    int ok = 1;
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 3; j++)
+            if (risultati[i][j] != atteso && (i == 1 || risultati[i][j] != 0))
+                ok = 0;
+    printf("%s: %llu terne con c <= %llu\n", ok ? "Risultato corretto" : "ERRORE", atteso, N);
+    return 0;
+}
@@ -1,94 +1,119 @@
+// Compilazione: gcc -O2 -fopenmp recursive_terne.c terneLib.c -o recursive_terne
 #include <stdio.h> // printf
-#include <time.h>  // clock, CLOCKS_PER_SEC
-#include <stdlib.h> // malloc, free
+#include <time.h>  // clock_gettime
+#include <string.h> // strcmp
+#include <fcntl.h> // open
+#include <unistd.h> // close, STDOUT_FILENO
+#include "terneLib.h" // albero di Berggren, scrittura delle terne
 
-#define MAX_TERNE 1000000000 // 1 miliardo
+typedef enum { TESTO, BINARIO, CONTA, STREAM } Modo;
 
-typedef struct {
-    int a;
-    int b;
-    int c;
-} Terna; // struttura le terne
-
-Terna *terne; // init delle terne
-int t = 0; // indice delle terne
-
-void salvaTerne(int a, int b, int c, int N) {
-    /*
-    Dato un tripletta (a, b, c) salva tutte le terne pitagoriche (k * a, k * b, k * c) con k <= N.
-    Perche? Perche se (a, b, c) è una terna pitagorica, allora (k * a, k * b, k * c) è una terna pitagorica per ogni k.
-    */
-    int k = 1;
-    while (k * c <= N) {
-        terne[t].a = k * a;
-        terne[t].b = k * b;
-        terne[t].c = k * c;
-        t++;
-        k++;
-    }
+// Scarta le terne: serve solo a contarle senza tenerle in memoria
+void ignoraTerne(const void *terne, size_t count, int bits, void *ctx) {
+    (void)terne;
+    (void)count;
+    (void)bits;
+    (void)ctx;
 }
 
-void generaTerne(int a, int b, int c, int N) {
-    /**
-     * Genera nuove terne pitagoriche primitive usando le trasformazioni di Berggren.
-     *
-     * Da una terna primitiva (a, b, c), si possono generare altre tre terne primarie:
-     * 
-     * 1. (a', b', c') dove:
-     *    a' = a - 2b + 2c
-     *    b' = 2a - b + 2c
-     *    c' = 2a - 2b + 3c
-     * 
-     * 2. (a', b', c') dove:
-     *    a' = a + 2b + 2c
-     *    b' = 2a + b + 2c
-     *    c' = 2a + 2b + 3c
-     * 
-     * 3. (a', b', c') dove:
-     *    a' = -a + 2b + 2c
-     *    b' = -2a + b + 2c
-     *    c' = -2a + 2b + 3c
-     * 
-     * Questa tecnica permette di generare ricorsivamente tutte le terne primitive.
-    **/
-    if (c > N)
-        return;
-    
-    salvaTerne(a, b, c, N);
-
-    generaTerne(a - 2 * b + 2 * c, 2 * a - b + 2 * c, 2 * a - 2 * b + 3 * c, N);
-    generaTerne(a + 2 * b + 2 * c, 2 * a + b + 2 * c, 2 * a + 2 * b + 3 * c, N);
-    generaTerne(-a + 2 * b + 2 * c, -2 * a + b + 2 * c, -2 * a + 2 * b + 3 * c, N);
+double secondi(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
 }
 
-int main() {
-    int N;
+// Uso: ./recursive_terne [testo|binario|conta|stream] [file]
+//   testo   -> (default) genera, poi scrive "(a, b, c)" su stdout o sul file
+//   binario -> genera, poi salva in formato binario a colonne (default terne.bin)
+//   conta   -> genera senza salvare ne' stampare e confronta il numero di terne con terne_conta()
+//   stream  -> scrive in testo mentre genera, senza tenere le terne in memoria
+int main(int argc, char *argv[]) {
+    Modo modo = TESTO;
+    if (argc > 1 && strcmp(argv[1], "binario") == 0)
+        modo = BINARIO;
+    else if (argc > 1 && strcmp(argv[1], "conta") == 0)
+        modo = CONTA;
+    else if (argc > 1 && strcmp(argv[1], "stream") == 0)
+        modo = STREAM;
+    const char *file = argc > 2 ? argv[2] : modo == BINARIO ? "terne.bin" : NULL;
+
+    unsigned long long N;
     printf("Inserisci il valore massimo N: ");
-    if (scanf("%d", &N) != 1) {
+    if (scanf("%llu", &N) != 1) {
         printf("Input non valido.\n");
         return 1;
     }
-
-    terne = (Terna *)malloc(MAX_TERNE * sizeof(Terna));
-    if (terne == NULL) {
-        printf("Errore di allocazione della memoria.\n");
+    // interi a 32 bit se bastano, altrimenti a 64; oltre TERNE64_MAX_N i conti traboccherebbero
+    int bits = terne_get_bits(N);
+    if (bits == 0) {
+        printf("N troppo grande: il massimo e' %llu.\n", (unsigned long long)TERNE64_MAX_N);
         return 1;
     }
 
-    clock_t start = clock(); // Inizio del calcolo del tempo
+    int fd = STDOUT_FILENO;
+    if (file && modo != CONTA) {
+        fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            perror(file);
+            return 1;
+        }
+    }
+
+    struct timespec start, end; // tempo reale: clock() sommerebbe il tempo di tutti i thread
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (modo == CONTA || modo == STREAM) {
+        // nessuna lista in memoria: ogni blocco di terne va subito al sink
+        TerneTesto w;
+        size_t t;
+        if (modo == STREAM) {
+            printf("Terne pitagoriche fino a %llu:\n", N);
+            fflush(stdout); // il testo delle terne esce con write(), dopo questo
+            terne_testo_init(&w, fd);
+            t = terne_berggren_sink(N, terne_testo_sink, &w);
+            terne_testo_close(&w);
+        } else {
+            t = terne_berggren_sink(N, ignoraTerne, NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%zu terne (interi a %d bit), tempo di esecuzione: %f secondi\n", t, bits, secondi(start, end));
+        if (modo == CONTA) {
+            // verifica con il conteggio senza generazione
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            uint64_t formula = terne_conta((uint64_t)N);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            printf("Somma di N / c sulle primitive: %llu terne in %f secondi -> %s\n",
+                   (unsigned long long)formula, secondi(start, end), formula == t ? "OK" : "ERRORE");
+        }
+        if (fd != STDOUT_FILENO)
+            close(fd);
+        return 0;
+    }
 
-    generaTerne(3, 4, 5, N);
+    // albero di Berggren senza ricorsione, sottoalberi divisi tra i thread;
+    // le terne finiscono in un'arena a blocchi che cresce quanto serve
+    TerneArena terne;
+    terne_berggren(N, &terne);
 
-    clock_t end = clock(); // Fine del calcolo del tempo
-    double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double time_spent = secondi(start, end);
 
-    printf("Terne pitagoriche fino a %d:\n", N);
-    for (int i = 0; i < t; i++) {
-        printf("(%d, %d, %d)\n", terne[i].a, terne[i].b, terne[i].c);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (modo == BINARIO) {
+        if (terne_scrivi_binario(fd, &terne) < 0)
+            perror(file);
+        else
+            printf("%zu terne fino a %llu salvate in %s (interi a %d bit)\n", terne.count, N, file, bits);
+    } else {
+        printf("Terne pitagoriche fino a %llu:\n", N);
+        fflush(stdout);
+        if (terne_scrivi_testo(fd, &terne) < 0)
+            perror(file ? file : "stdout");
     }
+    clock_gettime(CLOCK_MONOTONIC, &end);
 
-    printf("Tempo di esecuzione: %f secondi\n", time_spent);
+    printf("Tempo di esecuzione: %f secondi (scrittura: %f secondi)\n", time_spent, secondi(start, end));
 
-    free(terne);
+    if (fd != STDOUT_FILENO)
+        close(fd);
+    terne_arena_free(&terne);
     return 0;
 }
@@ -1,12 +1,16 @@
+// Compilazione: gcc -O2 [-fopenmp] terne.c terneLib.c -o terne
 #include <stdio.h>  // printf, scanf
 #include <time.h>  // clock, CLOCKS_PER_SEC
+#include <string.h> // strcmp
+#include <fcntl.h> // open
 #include <unistd.h> // write(), STDOUT_FILENO
-#define N 1000000000  // Numero massimo di terne
-int le_terne[N][3];  // Array di terne
-int a, b, c, t = 0;
-void terne(int max) {
-    for (int m = 1; m * m <= max; m++) { // Per ogni m
-        for (int n = m + 1; n * n <= max; n++) { // Per ogni n > m. +1 perche m < n
+#include "terneLib.h" // arena a blocchi, scrittura delle terne, mcd
+TerneArena le_terne;  // terne trovate: blocchi allocati man mano che servono
+unsigned long long a, b, c;
+
+void terne(unsigned long long max) {
+    for (unsigned long long m = 1; m * m <= max; m++) { // Per ogni m
+        for (unsigned long long n = m + 1; n * n <= max; n++) { // Per ogni n > m. +1 perche m < n
             /*
             Euclid's formula:
             a = n^2 - m^2
@@ -20,34 +24,78 @@ void terne(int max) {
             if (c > max) {
                 break;
             }
+            if ((n - m) % 2 == 0 || terne_mcd(m, n) != 1) {
+                continue; // non primitiva: verra' generata come multiplo di una primitiva
+            }
 
             /*
             Dato un tripletta (a, b, c) salva tutte le terne pitagoriche (k * a, k * b, k * c) con k <= N.
             Perche? Perche se (a, b, c) è una terna pitagorica, allora (k * a, k * b, k * c) è una terna pitagorica per ogni k.
             */
 
-            for (int k = 1; k * c <= max; k++) {                
-                le_terne[t][0] = k * a;
-                le_terne[t][1] = k * b;
-                le_terne[t][2] = k * c;
-                t++;
+            for (unsigned long long k = 1; k <= max / c; k++) {                
+                terne_arena_add(&le_terne, k * a, k * b, k * c);
             }
         }
     }
 }
 
-int main(void) {
-    int max;
+// Uso: ./terne [testo|binario|conta] [file]
+//   testo   -> (default) scrive "Terna i: a \t b \t c" su stdout o sul file. Ogni terna compare
+//              una volta sola: rispetto alla prima versione, che ripeteva i multipli generati
+//              da coppie (m, n) non primitive, le righe sono meno e la numerazione cambia.
+//   binario -> salva in formato binario a colonne (default terne.bin)
+//   conta   -> stampa solo quante sono, confrontandole con terne_conta()
+int main(int argc, char *argv[]) {
+    int binario = argc > 1 && strcmp(argv[1], "binario") == 0;
+    int conta = argc > 1 && strcmp(argv[1], "conta") == 0;
+    const char *file = argc > 2 ? argv[2] : binario ? "terne.bin" : NULL;
+
+    unsigned long long max;
     printf("Inserisci il valore max: ");
-    scanf("%d", &max);
+    if (scanf("%llu", &max) != 1) {
+        printf("Input non valido.\n");
+        return 1;
+    }
+    // terne a 32 bit se max lo permette, altrimenti a 64
+    int bits = terne_get_bits(max);
+    if (bits == 0) {
+        printf("max troppo grande: il massimo e' %llu.\n", (unsigned long long)TERNE64_MAX_N);
+        return 1;
+    }
+    terne_arena_init(&le_terne, bits);
     clock_t start = clock(); // Inizio del calcolo del tempo
     terne(max);
     clock_t end = clock(); // Fine del calcolo del tempo
     double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("Le terne pitagoriche sono:\n");
-    for (int i = 0; i < t; i++) {
-        printf("Terna %d: %d \t %d \t %d\n", i, le_terne[i][0], le_terne[i][1], le_terne[i][2]);
+
+    int fd = STDOUT_FILENO;
+    if (file && !conta) {
+        fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            perror(file);
+            return 1;
+        }
+    }
+    if (conta) {
+        uint64_t formula = terne_conta(max);
+        printf("Terne trovate: %zu, somma di N / c sulle primitive: %llu -> %s\n",
+               le_terne.count, (unsigned long long)formula, formula == le_terne.count ? "OK" : "ERRORE");
+    } else if (binario) {
+        if (terne_scrivi_binario(fd, &le_terne) < 0)
+            perror(file);
+        else
+            printf("%zu terne salvate in %s\n", le_terne.count, file);
+    } else {
+        // buffer grande e cifre convertite a mano invece di una printf per terna
+        printf("Le terne pitagoriche sono:\n");
+        fflush(stdout);
+        if (terne_scrivi_testo_numerate(fd, &le_terne) < 0)
+            perror(file ? file : "stdout");
     }
+    if (fd != STDOUT_FILENO)
+        close(fd);
     printf("Tempo di esecuzione: %f\n", time_spent);
+    terne_arena_free(&le_terne);
     return 0;
 }
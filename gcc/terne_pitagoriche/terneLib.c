@@ -0,0 +1,405 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "terneLib.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Il lavoro viene diviso tra i thread solo quando la visita in ampiezza ha prodotto almeno
+// FRONTIER_PER_THREAD sottoalberi per thread: con tanti sottoalberi lo scheduling dinamico
+// riesce a bilanciare rami di dimensioni molto diverse.
+#define FRONTIER_PER_THREAD 64
+
+// —— Scelta della larghezza ——
+static int bits_forzati = 0; // 0 = automatica
+
+void terne_set_bits(int bits) {
+    bits_forzati = bits == 32 || bits == 64 ? bits : 0;
+}
+
+int terne_get_bits(uint64_t N) {
+    if (N > TERNE64_MAX_N)
+        return 0;
+    if (N > TERNE32_MAX_N || bits_forzati == 64)
+        return 64;
+    return 32;
+}
+
+// byte occupati da una terna
+static size_t terna_size(int bits) {
+    return bits == 32 ? sizeof(Terna32) : sizeof(Terna64);
+}
+
+// Array che cresce raddoppiando (stack della visita e frontiera)
+typedef struct {
+    void *data;
+    size_t len, cap, elem;
+} Vettore;
+
+static void vettore_init(Vettore *v, size_t elem) {
+    v->data = NULL;
+    v->len = v->cap = 0;
+    v->elem = elem;
+}
+
+static void *vettore_push(Vettore *v) {
+    if (v->len == v->cap) {
+        v->cap = v->cap ? 2 * v->cap : 1024;
+        v->data = realloc(v->data, v->cap * v->elem);
+        if (!v->data) {
+            printf("Errore di allocazione della memoria.\n");
+            exit(1);
+        }
+    }
+    return (char *)v->data + v->len++ * v->elem;
+}
+
+// —— Arena a blocchi ——
+// I blocchi non si spostano mai (niente realloc + copia) e crescono raddoppiando da
+// ARENA_BLOCCO_MIN a ARENA_BLOCCO_MAX terne: la memoria segue le terne prodotte.
+#define ARENA_BLOCCO_MIN 1024
+#define ARENA_BLOCCO_MAX (1 << 16)
+
+// In modalita' sink ogni thread usa un solo blocco da SINK_BLOCCO terne, riusato dopo ogni consegna
+#define SINK_BLOCCO (1 << 14)
+
+void terne_arena_init(TerneArena *ar, int bits) {
+    ar->head = ar->tail = NULL;
+    ar->count = 0;
+    ar->bits = bits == 32 ? 32 : 64;
+}
+
+void terne_arena_free(TerneArena *ar) {
+    TerneChunk *ch = ar->head;
+    while (ch) {
+        TerneChunk *next = ch->next;
+        free(ch);
+        ch = next;
+    }
+    terne_arena_init(ar, ar->bits);
+}
+
+static TerneChunk *arena_nuovo_blocco(TerneArena *ar, size_t cap) {
+    TerneChunk *ch = malloc(sizeof(TerneChunk) + cap * terna_size(ar->bits));
+    if (!ch) {
+        printf("Errore di allocazione della memoria.\n");
+        exit(1);
+    }
+    ch->next = NULL;
+    ch->len = 0;
+    ch->cap = cap;
+    if (ar->tail)
+        ar->tail->next = ch;
+    else
+        ar->head = ch;
+    ar->tail = ch;
+    return ch;
+}
+
+// Blocco in coda con almeno un posto libero
+static TerneChunk *arena_spazio(TerneArena *ar) {
+    TerneChunk *ch = ar->tail;
+    if (ch && ch->len < ch->cap)
+        return ch;
+    size_t cap = ch ? 2 * ch->cap : ARENA_BLOCCO_MIN;
+    return arena_nuovo_blocco(ar, cap < ARENA_BLOCCO_MAX ? cap : ARENA_BLOCCO_MAX);
+}
+
+void terne_arena_add(TerneArena *ar, uint64_t a, uint64_t b, uint64_t c) {
+    TerneChunk *ch = arena_spazio(ar);
+    if (ar->bits == 32)
+        ((Terna32 *)ch->data)[ch->len++] = (Terna32){(uint32_t)a, (uint32_t)b, (uint32_t)c};
+    else
+        ((Terna64 *)ch->data)[ch->len++] = (Terna64){a, b, c};
+    ar->count++;
+}
+
+void terne_arena_sink(const void *terne, size_t count, int bits, void *arena) {
+    TerneArena *ar = arena;
+    size_t size = terna_size(bits);
+    const char *src = terne;
+    if (bits != ar->bits) {
+        printf("Errore: terne a %d bit in un'arena a %d bit.\n", bits, ar->bits);
+        exit(1);
+    }
+    while (count > 0) {
+        TerneChunk *ch = arena_spazio(ar);
+        size_t n = ch->cap - ch->len < count ? ch->cap - ch->len : count;
+        memcpy((char *)ch->data + ch->len * size, src, n * size);
+        ch->len += n;
+        ar->count += n;
+        src += n * size;
+        count -= n;
+    }
+}
+
+// Accoda i blocchi di src a dst senza copiarli; src resta vuota
+static void arena_unisci(TerneArena *dst, TerneArena *src) {
+    if (!src->head)
+        return;
+    if (dst->tail)
+        dst->tail->next = src->head;
+    else
+        dst->head = src->head;
+    dst->tail = src->tail;
+    dst->count += src->count;
+    terne_arena_init(src, src->bits);
+}
+
+// Destinazione delle terne di un thread: la sua arena oppure, se sink != NULL, un blocco
+// solo che viene consegnato al sink ogni volta che si riempie
+typedef struct {
+    TerneArena arena;
+    terne_sink sink;
+    void *ctx;
+} Uscita;
+
+static void uscita_consegna(Uscita *u) {
+    TerneChunk *ch = u->arena.head;
+    if (!ch || ch->len == 0)
+        return;
+    // il sink puo' non essere thread-safe: un thread alla volta
+    #pragma omp critical(terne_sink)
+    u->sink(ch->data, ch->len, u->arena.bits, u->ctx);
+    ch->len = 0;
+}
+
+static TerneChunk *uscita_spazio(Uscita *u) {
+    if (!u->sink)
+        return arena_spazio(&u->arena);
+    TerneChunk *ch = u->arena.head;
+    if (!ch)
+        return arena_nuovo_blocco(&u->arena, SINK_BLOCCO);
+    if (ch->len == ch->cap)
+        uscita_consegna(u);
+    return ch;
+}
+
+// —— Scrittura: funzioni comuni alle due larghezze ——
+// Niente printf per riga: le cifre si scrivono a mano in un buffer grande che va al
+// file descriptor con poche write().
+#define USCITA_BUFFER (1 << 20)
+
+// una riga "Terna i: a \t b \t c\n" occupa al massimo 4 * 20 cifre + 15 caratteri
+#define TESTO_RIGA_MAX 96
+
+// Coppie di cifre "00".."99": due cifre per divisione invece di una
+static const char cifre[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Scrive v in decimale a partire da p e restituisce il puntatore dopo l'ultima cifra
+static char *scrivi_numero(char *p, uint64_t v) {
+    char tmp[20];
+    char *q = tmp + sizeof(tmp);
+    while (v >= 100) {
+        unsigned d = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--q = cifre[d + 1];
+        *--q = cifre[d];
+    }
+    if (v >= 10) {
+        *--q = cifre[v * 2 + 1];
+        *--q = cifre[v * 2];
+    } else {
+        *--q = (char)('0' + v);
+    }
+    size_t n = (size_t)(tmp + sizeof(tmp) - q);
+    memcpy(p, q, n);
+    return p + n;
+}
+
+// write() completa: riprova finche' tutti i byte sono scritti
+static int scrivi_tutto(int fd, const void *data, size_t len) {
+    const char *p = data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0)
+            return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void testo_svuota(TerneTesto *w) {
+    if (w->len && scrivi_tutto(w->fd, w->buf, w->len) < 0)
+        perror("write");
+    w->len = 0;
+}
+
+// Intero senza segno in little-endian indipendentemente dall'ordine dei byte della macchina
+static void scrivi_le(uint8_t *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+// —— Codice per le due larghezze ——
+#define BITS 32
+#include "terneLib_tmpl.h"
+#undef BITS
+#define BITS 64
+#include "terneLib_tmpl.h"
+#undef BITS
+
+// —— Albero di Berggren ——
+static int num_thread(void) {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static Uscita *uscite_init(int threads, int bits, terne_sink sink, void *ctx) {
+    Uscita *out = malloc(threads * sizeof(Uscita));
+    if (!out) {
+        printf("Errore di allocazione della memoria.\n");
+        exit(1);
+    }
+    for (int i = 0; i < threads; i++) {
+        terne_arena_init(&out[i].arena, bits);
+        out[i].sink = sink;
+        out[i].ctx = ctx;
+    }
+    return out;
+}
+
+static void genera(uint64_t N, int bits, Uscita *u, int threads) {
+    if (bits == 32)
+        genera32((uint32_t)N, u, threads);
+    else
+        genera64(N, u, threads);
+}
+
+size_t terne_berggren(uint64_t N, TerneArena *out) {
+    int bits = terne_get_bits(N);
+    terne_arena_init(out, bits);
+    if (bits == 0) {
+        printf("N troppo grande: il massimo e' %llu.\n", (unsigned long long)TERNE64_MAX_N);
+        return 0;
+    }
+    if (N < 5)
+        return 0;
+
+    // arene dei thread unite alla fine: si spostano solo i puntatori ai blocchi
+    int threads = num_thread();
+    Uscita *u = uscite_init(threads, bits, NULL, NULL);
+    genera(N, bits, u, threads);
+    for (int i = 0; i < threads; i++)
+        arena_unisci(out, &u[i].arena);
+    free(u);
+    return out->count;
+}
+
+size_t terne_berggren_sink(uint64_t N, terne_sink sink, void *ctx) {
+    int bits = terne_get_bits(N);
+    if (bits == 0) {
+        printf("N troppo grande: il massimo e' %llu.\n", (unsigned long long)TERNE64_MAX_N);
+        return 0;
+    }
+    if (N < 5)
+        return 0;
+
+    int threads = num_thread();
+    Uscita *u = uscite_init(threads, bits, sink, ctx);
+    genera(N, bits, u, threads);
+    size_t count = 0;
+    for (int i = 0; i < threads; i++) {
+        uscita_consegna(&u[i]);
+        count += u[i].arena.count;
+        terne_arena_free(&u[i].arena);
+    }
+    free(u);
+    return count;
+}
+
+// —— Solo conteggio ——
+// Ogni primitiva con ipotenusa c <= N ha floor(N / c) multipli con ipotenusa <= N, quindi
+// il numero di terne e' la somma di N / c sulle primitive. Le primitive sono, una volta sola
+// ciascuna, le coppie m > n > 0 coprime e di parita' diversa, con c = m^2 + n^2.
+// m^2 + n^2 < 2N: la soglia dei 32 bit (N < 2^32 / 7) lascia margine.
+uint64_t terne_conta(uint64_t N) {
+    if (terne_get_bits(N) == 32)
+        return conta32((uint32_t)N);
+    return conta64(N);
+}
+
+uint64_t terne_mcd(uint64_t u, uint64_t v) {
+    if (u == 0 || v == 0)
+        return u | v; // mcd64 conta gli zeri finali, che per 0 non sono definiti
+    if ((u | v) <= UINT32_MAX)
+        return mcd32((uint32_t)u, (uint32_t)v);
+    return mcd64(u, v);
+}
+
+// —— Scrittura delle terne ——
+void terne_testo_init(TerneTesto *w, int fd) {
+    w->fd = fd;
+    w->len = 0;
+    w->numerate = 0;
+    w->indice = 0;
+    w->buf = malloc(USCITA_BUFFER);
+    if (!w->buf) {
+        printf("Errore di allocazione della memoria.\n");
+        exit(1);
+    }
+}
+
+void terne_testo_sink(const void *terne, size_t count, int bits, void *writer) {
+    if (bits == 32)
+        testo_righe32(writer, terne, count);
+    else
+        testo_righe64(writer, terne, count);
+}
+
+void terne_testo_close(TerneTesto *w) {
+    testo_svuota(w);
+    free(w->buf);
+    w->buf = NULL;
+}
+
+static int scrivi_testo(int fd, const TerneArena *ar, int numerate) {
+    TerneTesto w;
+    terne_testo_init(&w, fd);
+    w.numerate = numerate;
+    for (const TerneChunk *ch = ar->head; ch; ch = ch->next)
+        terne_testo_sink(ch->data, ch->len, ar->bits, &w);
+    // svuotamento finale controllando l'esito, poi come terne_testo_close
+    int err = w.len ? scrivi_tutto(fd, w.buf, w.len) : 0;
+    free(w.buf);
+    return err;
+}
+
+int terne_scrivi_testo(int fd, const TerneArena *ar) {
+    return scrivi_testo(fd, ar, 0);
+}
+
+int terne_scrivi_testo_numerate(int fd, const TerneArena *ar) {
+    return scrivi_testo(fd, ar, 1);
+}
+
+int terne_scrivi_binario(int fd, const TerneArena *ar) {
+    // intestazione: "TERNEBIN", versione, byte per valore, numero di terne
+    uint8_t header[TERNE_BIN_HEADER];
+    memcpy(header, "TERNEBIN", 8);
+    scrivi_le(header + 8, 1, 4);
+    scrivi_le(header + 12, (uint64_t)ar->bits / 8, 4);
+    scrivi_le(header + 16, ar->count, 8);
+    if (scrivi_tutto(fd, header, sizeof(header)) < 0)
+        return -1;
+
+    uint8_t *buf = malloc(USCITA_BUFFER);
+    if (!buf) {
+        printf("Errore di allocazione della memoria.\n");
+        exit(1);
+    }
+    // tre colonne una dopo l'altra: tutte le a, poi tutte le b, poi tutte le c
+    int err = 0;
+    for (int col = 0; col < 3 && !err; col++)
+        err = ar->bits == 32 ? binario_colonna32(fd, ar, col, buf) : binario_colonna64(fd, ar, col, buf);
+    free(buf);
+    return err ? -1 : 0;
+}
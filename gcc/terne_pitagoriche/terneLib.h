@@ -0,0 +1,111 @@
+#ifndef TERNELIB_H
+#define TERNELIB_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Le terne si generano a 32 o a 64 bit: per N piccolo basta la versione a 32 bit
+// (meta' memoria, piu' valori per registro SIMD), per N grande serve quella a 64.
+typedef struct {
+    uint32_t a, b, c;
+} Terna32;
+
+typedef struct {
+    uint64_t a, b, c;
+} Terna64;
+
+// N massimo per ciascuna larghezza: i figli di Berggren hanno ipotenusa fino a 7c,
+// che deve stare nel tipo anche quando poi viene scartata perche' > N.
+#define TERNE32_MAX_N (UINT32_MAX / 7)
+#define TERNE64_MAX_N (UINT64_MAX / 7)
+
+/** Forza la larghezza (32 o 64); 0 = automatica, la piu' stretta sicura per N (default).
+    Se N non sta nella larghezza forzata si usa comunque 64 bit. */
+void terne_set_bits(int bits);
+
+/** Larghezza usata per N: 32 o 64, oppure 0 se N supera TERNE64_MAX_N. */
+int terne_get_bits(uint64_t N);
+
+// Funzione chiamata con blocchi di terne appena generate (ordine non definito):
+// terne punta a count Terna32 o Terna64 secondo bits.
+// Il buffer viene riusato subito dopo: va copiato se serve dopo.
+typedef void (*terne_sink)(const void *terne, size_t count, int bits, void *ctx);
+
+// —— Arena a blocchi ——
+// Lista di blocchi che crescono su richiesta: nessun limite fissato a priori e nessuna
+// copia quando si allarga. Ogni blocco contiene len terne Terna32 o Terna64 (bits).
+typedef struct TerneChunk {
+    struct TerneChunk *next;
+    size_t len, cap;
+    uint64_t data[];    // terne, allineate a 8 byte
+} TerneChunk;
+
+typedef struct {
+    TerneChunk *head, *tail;
+    size_t count;       // terne totali
+    int bits;           // 32 o 64
+} TerneArena;
+
+void terne_arena_init(TerneArena *ar, int bits);
+void terne_arena_free(TerneArena *ar);
+void terne_arena_add(TerneArena *ar, uint64_t a, uint64_t b, uint64_t c);
+
+/** terne_sink che copia le terne ricevute nell'arena passata come ctx (stessa larghezza). */
+void terne_arena_sink(const void *terne, size_t count, int bits, void *arena);
+
+// —— Albero di Berggren ——
+/** Tutte le terne pitagoriche (primitive e multiple) con c <= N, salvate in *out
+    con la larghezza scelta da terne_get_bits(N).
+    L'albero delle primitive viene visitato con uno stack esplicito invece che per
+    ricorsione; con -fopenmp i sottoalberi sono divisi tra i thread e ognuno scrive
+    nella propria arena, unite alla fine senza copie (l'ordine delle terne non e' definito).
+    Restituisce quante sono (0 e messaggio di errore se N e' troppo grande). */
+size_t terne_berggren(uint64_t N, TerneArena *out);
+
+/** Come terne_berggren ma senza salvare la lista: ogni thread riempie un blocco di
+    dimensione fissa e lo passa a sink (una chiamata alla volta). Restituisce quante sono. */
+size_t terne_berggren_sink(uint64_t N, terne_sink sink, void *ctx);
+
+// —— Solo conteggio ——
+/** Numero di terne (primitive e multiple) con c <= N, senza generarle: somma di
+    floor(N / c) sulle ipotenuse primitive, con -fopenmp diviso tra i thread per m. */
+uint64_t terne_conta(uint64_t N);
+
+/** Massimo comun divisore (binario: solo shift e sottrazioni). terne_mcd(0, v) = v. */
+uint64_t terne_mcd(uint64_t u, uint64_t v);
+
+// —— Scrittura delle terne ——
+// Testo "(a, b, c)\n" con conversione delle cifre fatta a mano e un buffer da 1 MB
+// scritto con write(): da usare come sink (ctx = TerneTesto *) o su un'arena.
+// Con numerate = 1 le righe sono invece "Terna i: a \t b \t c\n" (i da 0).
+typedef struct {
+    int fd;
+    char *buf;
+    size_t len;
+    int numerate;
+    uint64_t indice;    // numero della prossima riga (solo con numerate)
+} TerneTesto;
+
+void terne_testo_init(TerneTesto *w, int fd);
+void terne_testo_sink(const void *terne, size_t count, int bits, void *writer);
+/** Scrive quanto resta nel buffer e lo libera (il file descriptor resta aperto). */
+void terne_testo_close(TerneTesto *w);
+
+/** Scrive in testo tutte le terne dell'arena. 0 se ok, -1 se write() fallisce. */
+int terne_scrivi_testo(int fd, const TerneArena *ar);
+/** Come terne_scrivi_testo, con le righe numerate "Terna i: a \t b \t c". */
+int terne_scrivi_testo_numerate(int fd, const TerneArena *ar);
+
+// Formato binario a colonne, tutti gli interi little-endian:
+//   byte  0..7   "TERNEBIN"
+//   byte  8..11  versione (1)
+//   byte 12..15  byte per valore (4 = uint32, 8 = uint64, come la larghezza dell'arena)
+//   byte 16..23  numero di terne n (uint64)
+//   poi n valori a, n valori b, n valori c
+#define TERNE_BIN_HEADER 24
+
+/** Scrive le terne dell'arena in formato binario a colonne. 0 se ok, -1 se write() fallisce. */
+int terne_scrivi_binario(int fd, const TerneArena *ar);
+
+#endif // TERNELIB_H
@@ -0,0 +1,214 @@
+// terneLib_tmpl.h
+// Parte di terneLib.c che dipende dalla larghezza degli interi. Viene inclusa due volte
+// da terneLib.c, con BITS definito a 32 e poi a 64: ogni inclusione genera le funzioni
+// NOME(f) = f32 / f64 che lavorano su T = uint32_t / uint64_t e TERNA = Terna32 / Terna64.
+// Tutti i conti sono senza segno: i risultati intermedi negativi (es. a - 2b) si
+// annullano modulo 2^BITS e il valore finale e' esatto finche' sta nel tipo, cosa
+// garantita da N <= TERNE<BITS>_MAX_N.
+
+#define CAT_(x, y) x##y
+#define CAT(x, y) CAT_(x, y)
+#define NOME(f) CAT(f, BITS)
+#define T CAT(CAT(uint, BITS), _t)
+#define TERNA CAT(Terna, BITS)
+#define NODO NOME(Nodo)
+
+// Nodo dell'albero: una terna primitiva
+typedef struct {
+    T a, b, c;
+} NODO;
+
+/*
+ * Dato un tripletta (a, b, c) salva tutte le terne pitagoriche (k * a, k * b, k * c) con k * c <= N.
+ * Perche? Perche se (a, b, c) è una terna pitagorica, allora (k * a, k * b, k * c) è una terna pitagorica per ogni k.
+ * Il ciclo interno non ha dipendenze tra iterazioni: il compilatore lo vettorizza.
+ */
+static void NOME(salva_multipli)(const NODO *p, T N, Uscita *u) {
+    T a = p->a, b = p->b, c = p->c;
+    T kmax = N / c;
+    u->arena.count += (size_t)kmax;
+    for (T k = 1; k <= kmax;) {
+        TerneChunk *ch = uscita_spazio(u);
+        TERNA *t = (TERNA *)ch->data + ch->len;
+        T n = (T)(ch->cap - ch->len) < kmax - k + 1 ? (T)(ch->cap - ch->len) : kmax - k + 1;
+        for (T i = 0; i < n; i++) {
+            t[i].a = a * (k + i);
+            t[i].b = b * (k + i);
+            t[i].c = c * (k + i);
+        }
+        k += n;
+        ch->len += (size_t)n;
+    }
+}
+
+/*
+ * Trasformazioni di Berggren: da una terna primitiva (a, b, c) si ottengono le tre figlie
+ *   ( a - 2b + 2c,  2a - b + 2c,  2a - 2b + 3c)
+ *   ( a + 2b + 2c,  2a + b + 2c,  2a + 2b + 3c)
+ *   (-a + 2b + 2c, -2a + b + 2c, -2a + 2b + 3c)
+ * e partendo da (3, 4, 5) si visitano tutte le primitive, ognuna una volta sola.
+ * Restituisce quante figlie hanno c <= N e le scrive in figli.
+ */
+static int NOME(figli)(const NODO *p, T N, NODO figli[3]) {
+    T a = p->a, b = p->b, c = p->c;
+    NODO f[3] = {
+        {a - 2 * b + 2 * c, 2 * a - b + 2 * c, 2 * a - 2 * b + 3 * c},
+        {a + 2 * b + 2 * c, 2 * a + b + 2 * c, 2 * a + 2 * b + 3 * c},
+        {2 * b + 2 * c - a, b + 2 * c - 2 * a, 2 * b + 3 * c - 2 * a},
+    };
+    int n = 0;
+    for (int i = 0; i < 3; i++)
+        if (f[i].c <= N)
+            figli[n++] = f[i];
+    return n;
+}
+
+// Visita in profondita' il sottoalbero di radice r con uno stack esplicito:
+// la memoria cresce con la profondita', non con la dimensione del sottoalbero.
+static void NOME(visita)(NODO r, T N, Vettore *stack, Uscita *out) {
+    stack->len = 0;
+    *(NODO *)vettore_push(stack) = r;
+    while (stack->len > 0) {
+        NODO p = ((NODO *)stack->data)[--stack->len];
+        NOME(salva_multipli)(&p, N, out);
+
+        NODO f[3];
+        int n = NOME(figli)(&p, N, f);
+        for (int i = 0; i < n; i++)
+            *(NODO *)vettore_push(stack) = f[i];
+    }
+}
+
+// Genera tutte le terne con c <= N in out[0..threads): un'uscita per thread,
+// la prima raccoglie anche i nodi dei primi livelli
+static void NOME(genera)(T N, Uscita *out, int threads) {
+    // visita in ampiezza dei primi livelli finche' i sottoalberi bastano per tutti i thread
+    Vettore frontiera, prossima;
+    vettore_init(&frontiera, sizeof(NODO));
+    vettore_init(&prossima, sizeof(NODO));
+    *(NODO *)vettore_push(&frontiera) = (NODO){3, 4, 5};
+    while (frontiera.len > 0 && frontiera.len < (size_t)threads * FRONTIER_PER_THREAD) {
+        prossima.len = 0;
+        for (size_t i = 0; i < frontiera.len; i++) {
+            NODO *p = &((NODO *)frontiera.data)[i];
+            NOME(salva_multipli)(p, N, &out[0]);
+            NODO f[3];
+            int n = NOME(figli)(p, N, f);
+            for (int j = 0; j < n; j++)
+                *(NODO *)vettore_push(&prossima) = f[j];
+        }
+        Vettore tmp = frontiera;
+        frontiera = prossima;
+        prossima = tmp;
+    }
+
+    // ogni thread prende un sottoalbero alla volta (schedule dynamic: chi finisce prima
+    // ne prende un altro) e lo visita con il proprio stack e la propria uscita
+    long n_radici = (long)frontiera.len;
+    #pragma omp parallel num_threads(threads)
+    {
+        int id = 0;
+#ifdef _OPENMP
+        id = omp_get_thread_num();
+#endif
+        Vettore stack;
+        vettore_init(&stack, sizeof(NODO));
+        #pragma omp for schedule(dynamic, 1)
+        for (long i = 0; i < n_radici; i++)
+            NOME(visita)(((NODO *)frontiera.data)[i], N, &stack, &out[id]);
+        free(stack.data);
+    }
+    free(frontiera.data);
+    free(prossima.data);
+}
+
+// MCD binario: solo shift e sottrazioni
+static T NOME(mcd)(T u, T v) {
+    int shift = __builtin_ctzll(u | v);
+    u >>= __builtin_ctzll(u);
+    while (v) {
+        v >>= __builtin_ctzll(v);
+        if (u > v) {
+            T t = u;
+            u = v;
+            v = t;
+        }
+        v -= u;
+    }
+    return u << shift;
+}
+
+// Somma di N / (m^2 + n^2) sulle coppie primitive: con T a 32 bit anche le divisioni
+// sono a 32 bit, molto piu' veloci di quelle a 64
+static uint64_t NOME(conta)(T N) {
+    uint64_t count = 0;
+    long long m_max = 1;
+    while ((T)(m_max + 1) * (T)(m_max + 1) + 1 <= N)
+        m_max++;
+
+    // per m grande il ciclo su n e' piu' lungo: blocchi piccoli e dinamici
+    #pragma omp parallel for schedule(dynamic, 64) reduction(+:count)
+    for (long long m = 2; m <= m_max; m++) {
+        T mm = (T)m * (T)m;
+        for (T n = m % 2 ? 2 : 1; n < (T)m && mm + n * n <= N; n += 2)
+            if (NOME(mcd)((T)m, n) == 1)
+                count += N / (mm + n * n);
+    }
+    return count;
+}
+
+static void NOME(testo_righe)(TerneTesto *w, const TERNA *terne, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (w->len + TESTO_RIGA_MAX > USCITA_BUFFER)
+            testo_svuota(w);
+        char *p = w->buf + w->len;
+        if (w->numerate) {
+            memcpy(p, "Terna ", 6);
+            p = scrivi_numero(p + 6, w->indice++);
+            memcpy(p, ": ", 2);
+            p = scrivi_numero(p + 2, terne[i].a);
+            memcpy(p, " \t ", 3);
+            p = scrivi_numero(p + 3, terne[i].b);
+            memcpy(p, " \t ", 3);
+            p = scrivi_numero(p + 3, terne[i].c);
+        } else {
+            *p++ = '(';
+            p = scrivi_numero(p, terne[i].a);
+            *p++ = ',';
+            *p++ = ' ';
+            p = scrivi_numero(p, terne[i].b);
+            *p++ = ',';
+            *p++ = ' ';
+            p = scrivi_numero(p, terne[i].c);
+            *p++ = ')';
+        }
+        *p++ = '\n';
+        w->len = (size_t)(p - w->buf);
+    }
+}
+
+// Colonna col (0 = a, 1 = b, 2 = c) di tutta l'arena in little-endian, a blocchi di buf
+static int NOME(binario_colonna)(int fd, const TerneArena *ar, int col, uint8_t *buf) {
+    size_t len = 0;
+    for (const TerneChunk *ch = ar->head; ch; ch = ch->next) {
+        const TERNA *t = (const TERNA *)ch->data;
+        for (size_t i = 0; i < ch->len; i++) {
+            T v = col == 0 ? t[i].a : col == 1 ? t[i].b : t[i].c;
+            scrivi_le(buf + len, v, BITS / 8);
+            len += BITS / 8;
+            if (len == USCITA_BUFFER) {
+                if (scrivi_tutto(fd, buf, len) < 0)
+                    return -1;
+                len = 0;
+            }
+        }
+    }
+    return len ? scrivi_tutto(fd, buf, len) : 0;
+}
+
+#undef CAT_
+#undef CAT
+#undef NOME
+#undef T
+#undef TERNA
+#undef NODO